@@ -1,13 +1,655 @@
+// Build: g++ -std=c++17 -O2 -pthread recursion.cpp -o recursion
+// (use -std=c++20 to add the coroutine generators)
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
-#include <vector>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 #include <string>
-#include <iomanip>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#endif
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// reverseFile maps windows of the file where POSIX mmap exists and reads
+// chunks with fstream elsewhere
+#if defined(__unix__) || defined(__APPLE__)
+#define RECURSION_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define RECURSION_USE_MMAP 0
+#endif
+
 using namespace std;
 
+// ============================================================================
+// ARBITRARY-PRECISION INTEGERS
+// ============================================================================
+
+/**
+ * Add a and b modulo m (both below m) without overflowing 64 bits
+ */
+unsigned long long addMod(unsigned long long a, unsigned long long b, unsigned long long m) {
+    return (a >= m - b) ? a - (m - b) : a + b;
+}
+
+/**
+ * Subtract b from a modulo m (both below m) without overflowing 64 bits
+ */
+unsigned long long subMod(unsigned long long a, unsigned long long b, unsigned long long m) {
+    return (a >= b) ? a - b : a + (m - b);
+}
+
+/**
+ * Multiply a and b modulo m without overflowing 64 bits
+ */
+unsigned long long mulMod(unsigned long long a, unsigned long long b, unsigned long long m) {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<unsigned long long>(static_cast<unsigned __int128>(a) * b % m);
+#else
+    // Double-and-add: never holds more than 2m
+    unsigned long long result = 0;
+    a %= m;
+    while (b > 0) {
+        if (b & 1) {
+            result = addMod(result, a, m);
+        }
+        a = addMod(a, a, m);
+        b >>= 1;
+    }
+    return result;
+#endif
+}
+
+/**
+ * Non-negative arbitrary-precision integer for exact Fibonacci numbers and
+ * factorials: addition, subtraction, multiplication and printing.
+ * Digits are kept in base 10000 (least significant limb first) so printing
+ * needs no division, and limb products summed over a long multiplication
+ * still fit in 64 bits. Large products use Karatsuba multiplication; a
+ * short operand times a long one is done in pieces the short one's size,
+ * so unbalanced products cost no more than they need to.
+ */
+class BigInteger {
+private:
+    static const int base = 10000;
+    static const int baseDigits = 4;
+    static const int karatsubaThreshold = 32;  // Limbs; below this schoolbook wins
+    
+    // Longest Karatsuba split (in limbs) whose uncarried coefficients are
+    // guaranteed to fit in a long long (about 4 million decimal digits)
+    static const int maxMultiplyLimbs = 1 << 20;
+    
+    vector<int> limbs;  // No leading zero limbs; empty means 0
+    
+    void trim() {
+        while (!limbs.empty() && limbs.back() == 0) {
+            limbs.pop_back();
+        }
+    }
+    
+    // Schoolbook product of a[0..n) and b[0..m) into out[0..n+m)
+    static void multiplySchoolbook(const long long* a, int n, const long long* b, int m, long long* out) {
+        fill(out, out + n + m, 0LL);
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < m; j++) {
+                out[i + j] += a[i] * b[j];
+            }
+        }
+    }
+    
+    // Karatsuba product of a[0..n) and b[0..n) into out[0..2n), without
+    // carrying; coefficients may grow past the base but stay far below
+    // the 64-bit limit for any size this class is used at
+    static void multiplyKaratsuba(const long long* a, const long long* b, int n, long long* out) {
+        if (n <= karatsubaThreshold) {
+            multiplySchoolbook(a, n, b, n, out);
+            return;
+        }
+        
+        // a = a0 + a1 * base^low, likewise b; a1 and b1 hold `high` limbs
+        int low = n / 2;
+        int high = n - low;
+        multiplyKaratsuba(a, b, low, out);                          // a0 * b0
+        multiplyKaratsuba(a + low, b + low, high, out + 2 * low);   // a1 * b1
+        
+        vector<long long> sums(2 * high);
+        for (int i = 0; i < high; i++) {
+            sums[i] = a[low + i] + (i < low ? a[i] : 0);
+            sums[high + i] = b[low + i] + (i < low ? b[i] : 0);
+        }
+        vector<long long> middle(2 * high);
+        multiplyKaratsuba(sums.data(), sums.data() + high, high, middle.data());
+        
+        // (a0 + a1)(b0 + b1) - a0*b0 - a1*b1 = a0*b1 + a1*b0
+        for (int i = 0; i < 2 * low; i++) {
+            middle[i] -= out[i];
+        }
+        for (int i = 0; i < 2 * high; i++) {
+            middle[i] -= out[2 * low + i];
+        }
+        for (int i = 0; i < 2 * high; i++) {
+            out[low + i] += middle[i];
+        }
+    }
+    
+public:
+    BigInteger(unsigned long long value = 0) {
+        while (value > 0) {
+            limbs.push_back(static_cast<int>(value % base));
+            value /= base;
+        }
+    }
+    
+    bool isZero() const {
+        return limbs.empty();
+    }
+    
+    // Compare magnitudes: negative, zero or positive like strcmp
+    int compare(const BigInteger& other) const {
+        if (limbs.size() != other.limbs.size()) {
+            return limbs.size() < other.limbs.size() ? -1 : 1;
+        }
+        for (size_t i = limbs.size(); i-- > 0;) {
+            if (limbs[i] != other.limbs[i]) {
+                return limbs[i] < other.limbs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+    
+    bool operator==(const BigInteger& other) const {
+        return limbs == other.limbs;
+    }
+    
+    BigInteger operator+(const BigInteger& other) const {
+        BigInteger result;
+        size_t length = max(limbs.size(), other.limbs.size());
+        result.limbs.resize(length + 1);
+        int carry = 0;
+        for (size_t i = 0; i < length; i++) {
+            int sum = carry + (i < limbs.size() ? limbs[i] : 0)
+                      + (i < other.limbs.size() ? other.limbs[i] : 0);
+            carry = sum >= base;
+            result.limbs[i] = sum - carry * base;
+        }
+        result.limbs[length] = carry;
+        result.trim();
+        return result;
+    }
+    
+    // Difference of two values (the result must not be negative)
+    BigInteger operator-(const BigInteger& other) const {
+        if (compare(other) < 0) {
+            throw underflow_error("BigInteger subtraction would go below zero!");
+        }
+        BigInteger result = *this;
+        int borrow = 0;
+        for (size_t i = 0; i < result.limbs.size(); i++) {
+            int difference = result.limbs[i] - borrow - (i < other.limbs.size() ? other.limbs[i] : 0);
+            borrow = difference < 0;
+            result.limbs[i] = difference + borrow * base;
+        }
+        result.trim();
+        return result;
+    }
+    
+    BigInteger operator*(const BigInteger& other) const {
+        if (isZero() || other.isZero()) {
+            return BigInteger();
+        }
+        
+        // `a` holds the longer operand and `b` the shorter one
+        const vector<int>& longer = limbs.size() >= other.limbs.size() ? limbs : other.limbs;
+        const vector<int>& shorter = limbs.size() >= other.limbs.size() ? other.limbs : limbs;
+        int n = static_cast<int>(longer.size());
+        int m = static_cast<int>(shorter.size());
+        if (m >= karatsubaThreshold && min(n, 2 * m) > maxMultiplyLimbs) {
+            throw length_error("BigInteger operands are too long to multiply exactly!");
+        }
+        vector<long long> a(longer.begin(), longer.end());
+        vector<long long> b(shorter.begin(), shorter.end());
+        vector<long long> product(n + m);
+        
+        if (m < karatsubaThreshold) {
+            multiplySchoolbook(a.data(), n, b.data(), m, product.data());
+        } else if (n < 2 * m) {
+            // Close enough in size to pad `b` and split both together
+            b.resize(n);
+            product.resize(2 * n);
+            multiplyKaratsuba(a.data(), b.data(), n, product.data());
+        } else {
+            // Multiply `a` in pieces of m limbs (the last one zero-padded)
+            // so each Karatsuba call splits two balanced operands
+            a.resize((n + m - 1) / m * m);
+            product.resize(a.size() + m);
+            vector<long long> piece(2 * m);
+            for (size_t offset = 0; offset < a.size(); offset += m) {
+                multiplyKaratsuba(a.data() + offset, b.data(), m, piece.data());
+                for (int i = 0; i < 2 * m; i++) {
+                    product[offset + i] += piece[i];
+                }
+            }
+        }
+        
+        BigInteger result;
+        result.limbs.resize(product.size());
+        long long carry = 0;
+        for (size_t i = 0; i < product.size(); i++) {
+            long long value = product[i] + carry;
+            result.limbs[i] = static_cast<int>(value % base);
+            carry = value / base;
+        }
+        result.trim();
+        return result;
+    }
+    
+    // This value modulo m (m at least 1)
+    unsigned long long mod(unsigned long long m) const {
+        unsigned long long result = 0;
+        for (size_t i = limbs.size(); i-- > 0;) {
+            result = addMod(mulMod(result, base, m), static_cast<unsigned long long>(limbs[i]) % m, m);
+        }
+        return result;
+    }
+    
+    // Number of decimal digits (1 for zero)
+    size_t digitCount() const {
+        if (limbs.empty()) {
+            return 1;
+        }
+        size_t digits = (limbs.size() - 1) * baseDigits;
+        for (int top = limbs.back(); top > 0; top /= 10) {
+            digits++;
+        }
+        return digits;
+    }
+    
+    string toString() const {
+        if (limbs.empty()) {
+            return "0";
+        }
+        string text = to_string(limbs.back());
+        for (size_t i = limbs.size() - 1; i-- > 0;) {
+            string limb = to_string(limbs[i]);
+            text += string(baseDigits - limb.size(), '0') + limb;
+        }
+        return text;
+    }
+    
+    friend ostream& operator<<(ostream& os, const BigInteger& value) {
+        return os << value.toString();
+    }
+};
+
+// ============================================================================
+// LAZY SEQUENCES
+// ============================================================================
+
+/**
+ * Lazy, pull-based range over a recurrence: a state, a step that moves the
+ * state to the next term, and a projection that reads the current term out
+ * of the state. Terms are computed one at a time as the range is iterated,
+ * so any prefix takes O(1) memory, and the step is never run past the last
+ * term asked for (which matters for sequences that overflow or get costly).
+ * 
+ * count limits the number of terms; -1 means the sequence never ends.
+ * take, skip and chunks return new ranges and leave this one unchanged.
+ * Ranges and their iterators share the step and projection, so an
+ * iterator stays valid after the range that made it is gone (as with
+ * fibonacciSequence().take(n).begin()).
+ */
+template <typename State, typename Step, typename Project>
+class RecurrenceRange {
+private:
+    struct Rule {
+        Step step;
+        Project project;
+    };
+    
+public:
+    using value_type = decay_t<invoke_result_t<Project, const State&>>;
+    
+    class iterator {
+    private:
+        shared_ptr<const Rule> rule;
+        State state;
+        long long remaining;  // Terms left including the current one
+        
+    public:
+        using iterator_category = input_iterator_tag;
+        using value_type = RecurrenceRange::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = value_type;
+        
+        iterator() : state(), remaining(0) {}
+        
+        iterator(shared_ptr<const Rule> shared, const State& start, long long count)
+            : rule(move(shared)), state(start), remaining(count) {}
+        
+        value_type operator*() const {
+            return rule->project(state);
+        }
+        
+        iterator& operator++() {
+            if (remaining > 0) {
+                remaining--;
+            }
+            if (remaining != 0) {
+                rule->step(state);
+            }
+            return *this;
+        }
+        
+        // Only the end of the range is ever compared against
+        bool operator==(const iterator& other) const {
+            return remaining == other.remaining;
+        }
+        
+        bool operator!=(const iterator& other) const {
+            return remaining != other.remaining;
+        }
+    };
+    
+    RecurrenceRange(State start, Step stepFunction, Project projectFunction, long long limit = -1)
+        : initial(move(start)),
+          rule(make_shared<const Rule>(Rule{move(stepFunction), move(projectFunction)})),
+          count(limit) {}
+    
+    iterator begin() const {
+        return iterator(rule, initial, count);
+    }
+    
+    iterator end() const {
+        return iterator();
+    }
+    
+    // The first n terms (fewer if the sequence ends sooner)
+    RecurrenceRange take(long long n) const {
+        RecurrenceRange result = *this;
+        result.count = (count < 0) ? max(n, 0LL) : min(count, max(n, 0LL));
+        return result;
+    }
+    
+    // Every term after the first n; the state is stepped n times here
+    RecurrenceRange skip(long long n) const {
+        RecurrenceRange result = *this;
+        if (count >= 0) {
+            n = min(n, count);
+            result.count = count - n;
+        }
+        for (long long i = 0; i < n && result.count != 0; i++) {
+            rule->step(result.initial);
+        }
+        return result;
+    }
+    
+    // The terms in batches of `size` (the last batch may be shorter)
+    auto chunks(size_t size) const;
+    
+private:
+    State initial;
+    shared_ptr<const Rule> rule;
+    long long count;
+};
+
+template <typename State, typename Step, typename Project>
+RecurrenceRange<State, Step, Project> makeRecurrence(State start, Step step, Project project, long long count = -1) {
+    return RecurrenceRange<State, Step, Project>(move(start), move(step), move(project), count);
+}
+
+/**
+ * Groups the terms of a lazy range into batches of up to `size` values
+ * for consumers that work a block at a time. One buffer is reused for
+ * every batch, so memory stays at one batch however long the range is.
+ */
+template <typename Range>
+class ChunkedRange {
+public:
+    using value_type = vector<typename Range::value_type>;
+    
+    class iterator {
+    private:
+        typename Range::iterator current;
+        typename Range::iterator last;
+        size_t size;
+        value_type batch;  // Empty once the range is used up
+        
+        void fill() {
+            batch.clear();
+            for (; batch.size() < size && current != last; ++current) {
+                batch.push_back(*current);
+            }
+        }
+        
+    public:
+        using iterator_category = input_iterator_tag;
+        using difference_type = ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+        
+        iterator() : size(0) {}
+        
+        iterator(typename Range::iterator first, typename Range::iterator end, size_t chunkSize)
+            : current(first), last(end), size(chunkSize) {
+            batch.reserve(size);
+            fill();
+        }
+        
+        const value_type& operator*() const {
+            return batch;
+        }
+        
+        iterator& operator++() {
+            fill();
+            return *this;
+        }
+        
+        bool operator==(const iterator& other) const {
+            return batch.empty() && other.batch.empty();
+        }
+        
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+    
+    ChunkedRange(Range source, size_t chunkSize) : range(move(source)), size(max<size_t>(chunkSize, 1)) {}
+    
+    iterator begin() const {
+        return iterator(range.begin(), range.end(), size);
+    }
+    
+    iterator end() const {
+        return iterator();
+    }
+    
+private:
+    Range range;
+    size_t size;
+};
+
+template <typename State, typename Step, typename Project>
+auto RecurrenceRange<State, Step, Project>::chunks(size_t size) const {
+    return ChunkedRange<RecurrenceRange>(*this, size);
+}
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#define RECURSION_HAS_COROUTINES 1
+
+/**
+ * C++20 coroutine generator: a function that co_yields values becomes a
+ * lazy input range. The body runs only as far as the consumer pulls, so
+ * like RecurrenceRange it needs O(1) memory for any prefix.
+ */
+template <typename T>
+class Generator {
+public:
+    struct promise_type {
+        T current;
+        
+        Generator get_return_object() {
+            return Generator(handle::from_promise(*this));
+        }
+        
+        suspend_always initial_suspend() noexcept {
+            return {};
+        }
+        
+        suspend_always final_suspend() noexcept {
+            return {};
+        }
+        
+        suspend_always yield_value(T value) {
+            current = move(value);
+            return {};
+        }
+        
+        void return_void() {}
+        
+        void unhandled_exception() {
+            throw;
+        }
+    };
+    
+    using handle = coroutine_handle<promise_type>;
+    using value_type = T;
+    
+    class iterator {
+    private:
+        handle coroutine;
+        
+    public:
+        using iterator_category = input_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+        
+        explicit iterator(handle h = nullptr) : coroutine(h) {}
+        
+        const T& operator*() const {
+            return coroutine.promise().current;
+        }
+        
+        iterator& operator++() {
+            coroutine.resume();
+            return *this;
+        }
+        
+        bool operator==(const iterator&) const {
+            return !coroutine || coroutine.done();
+        }
+        
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+    };
+    
+    explicit Generator(handle h) : coroutine(h) {}
+    
+    Generator(Generator&& other) noexcept : coroutine(exchange(other.coroutine, nullptr)) {}
+    
+    Generator(const Generator&) = delete;
+    Generator& operator=(const Generator&) = delete;
+    
+    ~Generator() {
+        if (coroutine) {
+            coroutine.destroy();
+        }
+    }
+    
+    // Runs the body up to its first co_yield; iterate only once
+    iterator begin() {
+        coroutine.resume();
+        return iterator(coroutine);
+    }
+    
+    iterator end() {
+        return iterator();
+    }
+    
+private:
+    handle coroutine;
+};
+
+// The first n values of a generator (it is not resumed past them)
+template <typename T>
+Generator<T> take(Generator<T> source, long long n) {
+    if (n <= 0) {
+        co_return;
+    }
+    for (const T& value : source) {
+        co_yield value;
+        if (--n == 0) {
+            co_return;
+        }
+    }
+}
+
+// Every value of a generator after the first n
+template <typename T>
+Generator<T> skip(Generator<T> source, long long n) {
+    for (const T& value : source) {
+        if (n > 0) {
+            n--;
+            continue;
+        }
+        co_yield value;
+    }
+}
+
+// The values of a generator in batches of `size`
+template <typename T>
+Generator<vector<T>> chunks(Generator<T> source, size_t size) {
+    vector<T> batch;
+    for (const T& value : source) {
+        batch.push_back(value);
+        if (batch.size() >= max<size_t>(size, 1)) {
+            co_yield move(batch);
+            batch.clear();
+        }
+    }
+    if (!batch.empty()) {
+        co_yield move(batch);
+    }
+}
+
+#else
+#define RECURSION_HAS_COROUTINES 0
+#endif
+
 // ============================================================================
 // PROBLEM 1: FACTORIAL CALCULATION
 // ============================================================================
 
+// Largest n whose factorial fits in a long long
+constexpr int maxLongLongFactorial = 20;
+
 /**
  * Recursive function to calculate factorial of a number
  * 
@@ -19,8 +661,14 @@ using namespace std;
  * 
  * @param n The number to calculate factorial for
  * @return The factorial of n
+ * @throws overflow_error if n! does not fit in a long long (n > 20);
+ *         use factorialBig for those
  */
-long long factorial(int n) {
+constexpr long long factorial(int n) {
+    if (n > maxLongLongFactorial) {
+        throw overflow_error(to_string(n) + "! does not fit in a long long!");
+    }
+    
     // Base case: factorial of 0 and 1 is 1
     if (n <= 1) {
         return 1;
@@ -30,138 +678,1412 @@ long long factorial(int n) {
     return n * factorial(n - 1);
 }
 
-// ============================================================================
-// PROBLEM 2: FIBONACCI SEQUENCE
-// ============================================================================
+/**
+ * Build a table of f(0), f(1), ..., f(N-1) at compile time
+ * 
+ * The index sequence expands to one call of f per entry, so the whole
+ * table is a constant the compiler writes straight into the program.
+ */
+template <typename T, typename F, size_t... I>
+constexpr array<T, sizeof...(I)> makeTable(F f, index_sequence<I...>) {
+    return {{f(static_cast<int>(I))...}};
+}
+
+// Every factorial that fits in a long long, computed by the compiler
+constexpr array<long long, maxLongLongFactorial + 1> factorialTable =
+    makeTable<long long>(factorial, make_index_sequence<maxLongLongFactorial + 1>());
+
+static_assert(factorialTable[0] == 1 && factorialTable[1] == 1, "0! and 1! must be 1");
+static_assert(factorialTable[5] == 120, "5! must be 120");
+static_assert(factorialTable[20] == 2432902008176640000LL, "20! must be 2432902008176640000");
+
+/**
+ * Factorial of n by a single checked table load
+ * 
+ * @param n The number to calculate factorial for (0 to 20)
+ * @return The factorial of n
+ * @throws out_of_range if n! is not in the table (use factorialBig)
+ */
+constexpr long long factorialLookup(int n) {
+    if (n < 0 || n > maxLongLongFactorial) {
+        throw out_of_range("factorialLookup covers 0! to " + to_string(maxLongLongFactorial) + "!");
+    }
+    return factorialTable[n];
+}
 
 /**
- * Recursive function to calculate the nth Fibonacci number
+ * Recursive helper multiplying every integer in [low, high) by binary
+ * splitting
  * 
- * BASE CASE: fib(0) = 0, fib(1) = 1
- * RECURSIVE CASE: fib(n) = fib(n-1) + fib(n-2)
+ * BASE CASE: a short range is multiplied directly in 64 bits
+ * RECURSIVE CASE: product(low, high) = product(low, mid) * product(mid, high)
  * 
- * Each Fibonacci number is the sum of the two preceding ones.
- * The recursion branches into two recursive calls until base cases are reached.
+ * Splitting the range in half keeps both factors about the same size, so
+ * the work goes into a few large balanced (Karatsuba) multiplications
+ * instead of n small ones, and the recursion is only log2(n) levels deep.
  * 
- * @param n The position in Fibonacci sequence (0-indexed)
- * @return The nth Fibonacci number
+ * @param low First factor
+ * @param high One past the last factor
+ * @return The product low * (low+1) * ... * (high-1) (1 for an empty range)
  */
-long long fibonacci(int n) {
-    // Base cases: first two Fibonacci numbers
-    if (n <= 0) {
-        return 0;
+BigInteger rangeProduct(unsigned long long low, unsigned long long high) {
+    // Base case: an empty range
+    if (high <= low) {
+        return BigInteger(1);
+    }
+    
+    // Base case: up to four factors below 2^16 fit in 64 bits together
+    if (high - low <= 4 && high <= 65536) {
+        unsigned long long product = 1;
+        for (unsigned long long i = low; i < high; i++) {
+            product *= i;
+        }
+        return BigInteger(product);
+    }
+    if (high - low == 1) {
+        return BigInteger(low);
+    }
+    
+    // Recursive case: multiply the two halves
+    unsigned long long mid = low + (high - low) / 2;
+    return rangeProduct(low, mid) * rangeProduct(mid, high);
+}
+
+/**
+ * Calculate n! exactly for any n by a binary-splitting product tree
+ * 
+ * @param n The number to calculate factorial for
+ * @return The factorial of n (1 for n <= 1)
+ */
+BigInteger factorialBig(int n) {
+    if (n <= maxLongLongFactorial) {
+        return BigInteger(static_cast<unsigned long long>(factorialLookup(max(n, 0))));
+    }
+    return rangeProduct(2, static_cast<unsigned long long>(n) + 1);
+}
+
+/**
+ * Recursive helper multiplying factors[low..high) (each below 2^32) by
+ * binary splitting, like rangeProduct
+ * 
+ * @return The product of the factors (1 for an empty range)
+ */
+BigInteger listProduct(const vector<unsigned long long>& factors, size_t low, size_t high) {
+    // Base case: one factor, or two that fit in 64 bits together
+    if (high - low <= 2) {
+        unsigned long long product = 1;
+        for (size_t i = low; i < high; i++) {
+            product *= factors[i];
+        }
+        return BigInteger(product);
+    }
+    
+    // Recursive case: multiply the two halves
+    size_t mid = low + (high - low) / 2;
+    return listProduct(factors, low, mid) * listProduct(factors, mid, high);
+}
+
+/**
+ * Calculate the binomial coefficient C(n, k) exactly
+ * 
+ * C(n, k) = n! / (k! (n-k)!) is built from its prime factorization, which
+ * needs no big-integer division: by Legendre's formula the prime p appears
+ * (sum over i of floor(n/p^i) - floor(k/p^i) - floor((n-k)/p^i)) times.
+ * The prime powers are then multiplied together by binary splitting.
+ * 
+ * @param n Size of the set
+ * @param k Size of the subsets
+ * @return C(n, k) (0 when k < 0 or k > n)
+ */
+BigInteger binomialBig(int n, int k) {
+    if (k < 0 || n < 0 || k > n) {
+        return BigInteger(0);
+    }
+    
+    // Sieve the primes up to n
+    vector<bool> composite(n + 1, false);
+    vector<unsigned long long> powers;
+    for (int p = 2; p <= n; p++) {
+        if (composite[p]) {
+            continue;
+        }
+        for (long long multiple = 1LL * p * p; multiple <= n; multiple += p) {
+            composite[multiple] = true;
+        }
+        
+        int exponent = 0;
+        for (long long power = p; power <= n; power *= p) {
+            exponent += static_cast<int>(n / power - k / power - (n - k) / power);
+        }
+        
+        // Gather p^exponent into factors below 2^32 so products of two
+        // factors still fit in 64 bits
+        unsigned long long factor = 1;
+        for (int i = 0; i < exponent; i++) {
+            if (factor * p >= (1ULL << 32)) {
+                powers.push_back(factor);
+                factor = 1;
+            }
+            factor *= p;
+        }
+        if (factor > 1) {
+            powers.push_back(factor);
+        }
+    }
+    
+    return listProduct(powers, 0, powers.size());
+}
+
+/**
+ * Lazy sequence of the factorials 0!, 1!, ..., 20! (every one that fits in
+ * a long long), each one step from the last
+ */
+auto factorialSequence() {
+    return makeRecurrence(
+        pair<long long, long long>(0, 1),
+        [](pair<long long, long long>& state) {
+            state.first++;
+            state.second *= state.first;
+        },
+        [](const pair<long long, long long>& state) { return state.second; },
+        maxLongLongFactorial + 1);
+}
+
+/**
+ * Endless lazy sequence of exact factorials 0!, 1!, 2!, ...
+ */
+auto factorialSequenceBig() {
+    return makeRecurrence(
+        pair<unsigned long long, BigInteger>(0, BigInteger(1)),
+        [](pair<unsigned long long, BigInteger>& state) {
+            state.first++;
+            state.second = state.second * BigInteger(state.first);
+        },
+        [](const pair<unsigned long long, BigInteger>& state) { return state.second; });
+}
+
+#if RECURSION_HAS_COROUTINES
+// Coroutine version of factorialSequence
+Generator<long long> factorialGenerator() {
+    long long factorial = 1;
+    for (int n = 0; n <= maxLongLongFactorial; n++) {
+        if (n > 0) {
+            factorial *= n;
+        }
+        co_yield factorial;
+    }
+}
+
+// Coroutine version of factorialSequenceBig
+Generator<BigInteger> factorialGeneratorBig() {
+    BigInteger factorial(1);
+    for (unsigned long long n = 0;; n++) {
+        if (n > 0) {
+            factorial = factorial * BigInteger(n);
+        }
+        co_yield factorial;
+    }
+}
+#endif
+
+// ============================================================================
+// PROBLEM 2: FIBONACCI SEQUENCE
+// ============================================================================
+
+/**
+ * Recursive helper returning the pair (fib(n), fib(n+1)) by fast doubling
+ * 
+ * BASE CASE: n = 0 gives (fib(0), fib(1)) = (0, 1)
+ * RECURSIVE CASE: from (a, b) = (fib(k), fib(k+1)) with k = n / 2
+ *   fib(2k)   = a * (2b - a)
+ *   fib(2k+1) = a^2 + b^2
+ * 
+ * Each call halves n, so only about log2(n) calls are made instead of the
+ * exponential number the textbook fib(n-1) + fib(n-2) recursion needs.
+ * The arithmetic wraps modulo 2^64, which is exact for every result that
+ * fits in a long long even when an intermediate value does not.
+ * 
+ * @param n The position in Fibonacci sequence (0-indexed)
+ * @return fib(n) and fib(n+1), modulo 2^64
+ */
+constexpr pair<unsigned long long, unsigned long long> fibonacciPair(int n) {
+    // Base case: the first two Fibonacci numbers
+    if (n == 0) {
+        return {0, 1};
+    }
+    
+    // Recursive case: double up from the pair at n / 2
+    pair<unsigned long long, unsigned long long> half = fibonacciPair(n / 2);
+    unsigned long long a = half.first;
+    unsigned long long b = half.second;
+    unsigned long long even = a * (2 * b - a);
+    unsigned long long odd = a * a + b * b;
+    if (n % 2 == 0) {
+        return {even, odd};
+    }
+    return {odd, even + odd};
+}
+
+// Largest n whose Fibonacci number fits in a long long
+constexpr int maxLongLongFibonacci = 92;
+
+/**
+ * Calculate the nth Fibonacci number in O(log n) steps
+ * 
+ * @param n The position in Fibonacci sequence (0-indexed)
+ * @return The nth Fibonacci number (0 for negative n)
+ * @throws overflow_error if fib(n) does not fit in a long long
+ *         (use fibonacciBig for those)
+ */
+constexpr long long fibonacci(int n) {
+    if (n <= 0) {
+        return 0;
+    }
+    if (n > maxLongLongFibonacci) {
+        throw overflow_error("fib(" + to_string(n) + ") does not fit in a long long!");
+    }
+    return static_cast<long long>(fibonacciPair(n).first);
+}
+
+// Every Fibonacci number that fits in a long long, computed by the compiler
+constexpr array<long long, maxLongLongFibonacci + 1> fibonacciTable =
+    makeTable<long long>(fibonacci, make_index_sequence<maxLongLongFibonacci + 1>());
+
+static_assert(fibonacciTable[0] == 0 && fibonacciTable[1] == 1, "fib(0) and fib(1) must be 0 and 1");
+static_assert(fibonacciTable[40] == 102334155, "fib(40) must be 102334155");
+static_assert(fibonacciTable[92] == 7540113804746346429LL, "fib(92) must be 7540113804746346429");
+
+/**
+ * Verify at compile time that every table entry is the sum of the two
+ * before it (recursive, one entry per call)
+ */
+constexpr bool fibonacciTableConsistent(int n = 2) {
+    if (n > maxLongLongFibonacci) {
+        return true;
+    }
+    return fibonacciTable[n] == fibonacciTable[n - 1] + fibonacciTable[n - 2]
+           && fibonacciTableConsistent(n + 1);
+}
+
+static_assert(fibonacciTableConsistent(), "Every Fibonacci entry must be the sum of the two before it");
+
+/**
+ * The nth Fibonacci number by a single checked table load
+ * 
+ * @param n The position in Fibonacci sequence (0 to 92)
+ * @return The nth Fibonacci number
+ * @throws out_of_range if fib(n) is not in the table (use fibonacciBig)
+ */
+constexpr long long fibonacciLookup(int n) {
+    if (n < 0 || n > maxLongLongFibonacci) {
+        throw out_of_range("fibonacciLookup covers fib(0) to fib(" + to_string(maxLongLongFibonacci) + ")");
+    }
+    return fibonacciTable[n];
+}
+
+#if defined(__cpp_consteval)
+/**
+ * fib(n) that must be worked out by the compiler: a call with anything
+ * but a constant argument, or one outside the table, fails to compile
+ */
+consteval long long fibonacciConstant(int n) {
+    return fibonacciLookup(n);
+}
+#endif
+
+/**
+ * Lazy sequence of fib(0), fib(1), ..., fib(92) (every Fibonacci number
+ * that fits in a long long)
+ * 
+ * Each number is the sum of the two before it, so each term costs O(1)
+ * work and the sequence needs O(1) memory however much of it is used.
+ * The state is kept unsigned: the last step computes fib(93) as the next
+ * term, which fits in an unsigned long long but not a long long.
+ */
+auto fibonacciSequence() {
+    return makeRecurrence(
+        pair<unsigned long long, unsigned long long>(0, 1),
+        [](pair<unsigned long long, unsigned long long>& state) {
+            state = {state.second, state.first + state.second};
+        },
+        [](const pair<unsigned long long, unsigned long long>& state) {
+            return static_cast<long long>(state.first);
+        },
+        maxLongLongFibonacci + 1);
+}
+
+/**
+ * Endless lazy sequence of exact Fibonacci numbers
+ */
+auto fibonacciSequenceBig() {
+    return makeRecurrence(
+        pair<BigInteger, BigInteger>(BigInteger(0), BigInteger(1)),
+        [](pair<BigInteger, BigInteger>& state) {
+            state.first = state.first + state.second;
+            swap(state.first, state.second);
+        },
+        [](const pair<BigInteger, BigInteger>& state) { return state.first; });
+}
+
+#if RECURSION_HAS_COROUTINES
+// Coroutine version of fibonacciSequence
+Generator<long long> fibonacciGenerator() {
+    unsigned long long current = 0;
+    unsigned long long next = 1;
+    for (int n = 0; n <= maxLongLongFibonacci; n++) {
+        co_yield static_cast<long long>(current);
+        current = exchange(next, current + next);
+    }
+}
+
+// Coroutine version of fibonacciSequenceBig
+Generator<BigInteger> fibonacciGeneratorBig() {
+    BigInteger current(0);
+    BigInteger next(1);
+    while (true) {
+        co_yield current;
+        current = current + next;
+        swap(current, next);
+    }
+}
+#endif
+
+/**
+ * Helper function to generate first n Fibonacci numbers into a vector
+ * (callers that only iterate once can use fibonacciSequence directly)
+ * 
+ * @param n Number of Fibonacci numbers to generate
+ * @return Vector containing the first n Fibonacci numbers
+ * @throws overflow_error if the sequence would go past fib(92)
+ */
+vector<long long> generateFibonacci(int n) {
+    if (n > maxLongLongFibonacci + 1) {
+        throw overflow_error("The first " + to_string(n) + " Fibonacci numbers do not fit in a long long!");
+    }
+    
+    vector<long long> result;
+    result.reserve(max(n, 0));
+    for (long long value : fibonacciSequence().take(n)) {
+        result.push_back(value);
+    }
+    return result;
+}
+
+/**
+ * Calculate fib(n) mod m by fast doubling (for hashing and sequence
+ * workloads that only need the residue)
+ * 
+ * @param n The position in Fibonacci sequence (0-indexed)
+ * @param m The modulus (at least 1)
+ * @return fib(n) mod m
+ */
+unsigned long long fibonacciMod(unsigned long long n, unsigned long long m) {
+    if (m == 0) {
+        throw invalid_argument("Modulus must be at least 1!");
+    }
+    
+    // Walk the bits of n from the top, keeping (fib(k), fib(k+1)) mod m
+    unsigned long long a = 0;
+    unsigned long long b = 1 % m;
+    for (int bit = 63; bit >= 0; bit--) {
+        // Every sum goes through addMod/subMod: with m above 2^63 even a
+        // sum of two residues can wrap around 64 bits
+        unsigned long long even = mulMod(a, subMod(addMod(b, b, m), a, m), m);
+        unsigned long long odd = addMod(mulMod(a, a, m), mulMod(b, b, m), m);
+        if ((n >> bit) & 1) {
+            a = odd;
+            b = addMod(even, odd, m);
+        } else {
+            a = even;
+            b = odd;
+        }
+    }
+    return a;
+}
+
+/**
+ * Calculate the exact nth Fibonacci number for any n by fast doubling
+ * 
+ * Uses the same doubling formulas as fibonacciPair, walking the bits of n
+ * from the top. The cost is dominated by the last few multiplications, so
+ * fib(1000000) (208988 digits) takes a fraction of a second.
+ * 
+ * @param n The position in Fibonacci sequence (0-indexed)
+ * @return The nth Fibonacci number
+ */
+BigInteger fibonacciBig(int n) {
+    BigInteger a(0);
+    BigInteger b(1);
+    if (n <= 0) {
+        return a;
+    }
+    
+    int bit = 0;
+    while ((n >> (bit + 1)) > 0) {
+        bit++;
+    }
+    for (; bit >= 0; bit--) {
+        BigInteger even = a * (b + b - a);
+        BigInteger odd = a * a + b * b;
+        if ((n >> bit) & 1) {
+            a = odd;
+            b = even + odd;
+        } else {
+            a = even;
+            b = odd;
+        }
+    }
+    return a;
+}
+
+// ============================================================================
+// PROBLEM 3: STRING REVERSAL
+// ============================================================================
+
+/**
+ * Recursive function to reverse a string
+ * 
+ * BASE CASE: Empty string or single character returns itself
+ * RECURSIVE CASE: Last character + reverse(remaining string)
+ * 
+ * The function takes the last character and prepends it to the reversed
+ * version of the string without that last character.
+ * 
+ * @param str The string to reverse
+ * @return Reversed string
+ */
+string reverseString(string str) {
+    // Base case: empty string or single character
+    if (str.length() <= 1) {
+        return str;
+    }
+    
+    // Recursive case: last character + reverse of remaining string
+    // Take last character and concatenate with reverse of substring
+    return str[str.length() - 1] + reverseString(str.substr(0, str.length() - 1));
+}
+
+// Alternative implementation using first character
+string reverseStringAlt(string str) {
+    // Base case: empty string or single character
+    if (str.length() <= 1) {
+        return str;
+    }
+    
+    // Recursive case: reverse of remaining + first character
+    return reverseStringAlt(str.substr(1)) + str[0];
+}
+
+/**
+ * Recursive helper for reverseLiteral: swap the outermost pair of
+ * characters, then reverse what lies between them
+ * 
+ * BASE CASE: left >= right (nothing left to swap)
+ * RECURSIVE CASE: swap text[left] and text[right], recurse inwards
+ */
+template <size_t N>
+constexpr void reverseBetween(array<char, N>& text, size_t left, size_t right) {
+    if (left >= right) {
+        return;
+    }
+    char first = text[left];
+    text[left] = text[right];
+    text[right] = first;
+    reverseBetween(text, left + 1, right - 1);
+}
+
+/**
+ * Reverse a string literal, at compile time when used in a constant
+ * expression (the result keeps the terminating '\0')
+ * 
+ * @param str A string literal of N - 1 characters
+ * @return The reversed characters followed by '\0'
+ */
+template <size_t N>
+constexpr array<char, N> reverseLiteral(const char (&str)[N]) {
+    array<char, N> result{};
+    for (size_t i = 0; i < N; i++) {
+        result[i] = str[i];
+    }
+    if (N > 2) {
+        reverseBetween(result, 0, N - 2);
+    }
+    return result;
+}
+
+// Compare a null-terminated character array with a string literal
+template <size_t N>
+constexpr bool sameText(const array<char, N>& text, const char (&expected)[N]) {
+    for (size_t i = 0; i < N; i++) {
+        if (text[i] != expected[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(sameText(reverseLiteral("hello"), "olleh"), "reverseLiteral must reverse 'hello'");
+static_assert(sameText(reverseLiteral(""), ""), "reverseLiteral must keep an empty string empty");
+static_assert(sameText(reverseLiteral("ab"), "ba"), "reverseLiteral must swap two characters");
+
+// ----------------------------------------------------------------------------
+// Reversal engine for large buffers
+// ----------------------------------------------------------------------------
+// The recursive versions above copy the string at every level (O(n^2) time
+// and allocation) and recurse once per character, so a 1 MB input
+// overflows the stack. The functions below reverse in O(n) with no
+// allocation, a vector register's worth of bytes at a time.
+
+#if defined(__AVX2__)
+constexpr size_t reverseBlockBytes = 32;
+
+// Reverse the bytes of one 32-byte block
+inline void reverseBlock(const char* source, char* destination) {
+    const __m256i order = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                           15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+    block = _mm256_shuffle_epi8(block, order);           // Reverse within each half
+    block = _mm256_permute2x128_si256(block, block, 1);  // Swap the halves
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination), block);
+}
+#elif defined(__SSSE3__)
+constexpr size_t reverseBlockBytes = 16;
+
+inline void reverseBlock(const char* source, char* destination) {
+    const __m128i order = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), _mm_shuffle_epi8(block, order));
+}
+#elif defined(__SSE2__)
+constexpr size_t reverseBlockBytes = 16;
+
+// SSE2 has no byte shuffle: reverse the 32-bit words, then the 16-bit
+// halves of each word, then the bytes of each half
+inline void reverseBlock(const char* source, char* destination) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    block = _mm_shuffle_epi32(block, _MM_SHUFFLE(0, 1, 2, 3));
+    block = _mm_shufflelo_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+    block = _mm_shufflehi_epi16(block, _MM_SHUFFLE(2, 3, 0, 1));
+    block = _mm_or_si128(_mm_slli_epi16(block, 8), _mm_srli_epi16(block, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), block);
+}
+#else
+constexpr size_t reverseBlockBytes = 0;  // Scalar only
+#endif
+
+/**
+ * Swap [front, front + count) with [backEnd - count, backEnd), reversing
+ * both, one byte at a time (the ranges must not overlap)
+ */
+inline void swapReversedScalar(char* front, char* backEnd, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        char byte = front[i];
+        front[i] = backEnd[-1 - static_cast<ptrdiff_t>(i)];
+        backEnd[-1 - static_cast<ptrdiff_t>(i)] = byte;
+    }
+}
+
+/**
+ * Swap [front, front + count) with [backEnd - count, backEnd), reversing
+ * both: the core step of every in-place reversal below. Whole blocks go
+ * through vector registers; the ranges must not overlap.
+ */
+inline void swapReversed(char* front, char* backEnd, size_t count) {
+#if defined(__AVX2__) || defined(__SSE2__)
+    char frontBlock[reverseBlockBytes];
+    while (count >= reverseBlockBytes) {
+        backEnd -= reverseBlockBytes;
+        reverseBlock(front, frontBlock);
+        reverseBlock(backEnd, front);
+        memcpy(backEnd, frontBlock, reverseBlockBytes);
+        front += reverseBlockBytes;
+        count -= reverseBlockBytes;
+    }
+#endif
+    swapReversedScalar(front, backEnd, count);
+}
+
+/**
+ * Reverse a buffer in place, one byte at a time (the fallback, and the
+ * baseline the vector version is measured against)
+ */
+inline void reverseInPlaceScalar(char* data, size_t length) {
+    swapReversedScalar(data, data + length, length / 2);
+}
+
+/**
+ * Reverse a buffer in place in O(n) time and O(1) extra memory
+ * 
+ * @param data The bytes to reverse
+ * @param length Number of bytes
+ */
+inline void reverseInPlace(char* data, size_t length) {
+    swapReversed(data, data + length, length / 2);
+}
+
+inline void reverseInPlace(string& str) {
+    reverseInPlace(&str[0], str.size());
+}
+
+/**
+ * Write the bytes of source in reverse order into a caller-supplied
+ * buffer, which must hold length bytes and not overlap source
+ */
+inline void reverseInto(const char* source, size_t length, char* destination) {
+    size_t done = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+    for (; done + reverseBlockBytes <= length; done += reverseBlockBytes) {
+        reverseBlock(source + length - done - reverseBlockBytes, destination + done);
+    }
+#endif
+    for (; done < length; done++) {
+        destination[done] = source[length - 1 - done];
+    }
+}
+
+// Inputs shorter than this are reversed on the calling thread
+constexpr size_t minParallelReverseBytes = 1 << 20;
+
+/**
+ * Reverse a large buffer in place on several threads
+ * 
+ * The front half is cut into one slice per thread; each thread swaps its
+ * slice with the mirror-image slice of the back half, so no two threads
+ * touch the same bytes.
+ * 
+ * @param data The bytes to reverse
+ * @param length Number of bytes
+ * @param threads Threads to use (0 for one per hardware thread)
+ */
+void reverseParallel(char* data, size_t length, int threads = 0) {
+    if (threads <= 0) {
+        threads = static_cast<int>(max(1u, thread::hardware_concurrency()));
+    }
+    size_t half = length / 2;
+    if (threads == 1 || length < minParallelReverseBytes) {
+        reverseInPlace(data, length);
+        return;
+    }
+    
+    vector<thread> workers;
+    size_t slice = (half + threads - 1) / threads;
+    for (size_t first = 0; first < half; first += slice) {
+        size_t count = min(slice, half - first);
+        workers.emplace_back(swapReversed, data + first, data + length - first, count);
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+// How reverseUtf8 groups bytes before reversing
+enum class Utf8Units {
+    CodePoints,  // Each encoded character keeps its bytes in order
+    Graphemes    // Base characters keep their combining marks, emoji
+                 // ZWJ sequences, skin tones and flags stay whole
+};
+
+/**
+ * Length of the UTF-8 sequence starting at data[i]: the length its lead
+ * byte announces, cut short at the first byte that is not a continuation
+ * (so malformed input is reversed byte by byte instead of being mangled)
+ */
+size_t utf8SequenceLength(const unsigned char* data, size_t length, size_t i) {
+    unsigned char lead = data[i];
+    size_t expected = (lead < 0xC0) ? 1 : (lead < 0xE0) ? 2 : (lead < 0xF0) ? 3 : 4;
+    size_t count = 1;
+    while (count < expected && i + count < length && (data[i + count] & 0xC0) == 0x80) {
+        count++;
+    }
+    return count;
+}
+
+// Code point of the sequence at data[i] of the given length
+uint32_t utf8Decode(const unsigned char* data, size_t i, size_t count) {
+    static const unsigned char leadMask[] = {0, 0x7F, 0x1F, 0x0F, 0x07};
+    uint32_t codePoint = data[i] & leadMask[count];
+    for (size_t k = 1; k < count; k++) {
+        codePoint = (codePoint << 6) | (data[i + k] & 0x3F);
+    }
+    return codePoint;
+}
+
+// Code points that attach to the character before them
+bool extendsGrapheme(uint32_t codePoint) {
+    return (codePoint >= 0x0300 && codePoint <= 0x036F)       // Combining diacritical marks
+           || (codePoint >= 0x1AB0 && codePoint <= 0x1AFF)
+           || (codePoint >= 0x1DC0 && codePoint <= 0x1DFF)
+           || (codePoint >= 0x20D0 && codePoint <= 0x20FF)
+           || (codePoint >= 0xFE20 && codePoint <= 0xFE2F)
+           || (codePoint >= 0xFE00 && codePoint <= 0xFE0F)    // Variation selectors
+           || (codePoint >= 0x1F3FB && codePoint <= 0x1F3FF)  // Skin tone modifiers
+           || (codePoint >= 0xE0020 && codePoint <= 0xE007F)  // Emoji tag sequences
+           || codePoint == 0x200D;                            // Zero width joiner
+}
+
+bool isRegionalIndicator(uint32_t codePoint) {
+    return codePoint >= 0x1F1E6 && codePoint <= 0x1F1FF;
+}
+
+/**
+ * Reverse UTF-8 text in place by code point or by grapheme cluster
+ * 
+ * Every unit is reversed on its own first, then the whole buffer is
+ * reversed: each unit lands in mirrored position with its bytes back in
+ * their original order. Grapheme clusters follow the common cases of
+ * Unicode's rules (combining marks, ZWJ sequences, variation selectors,
+ * skin tones, flag pairs and CR LF), not the full tables.
+ * 
+ * @param data UTF-8 bytes to reverse
+ * @param length Number of bytes
+ * @param units What to keep whole
+ */
+void reverseUtf8(char* data, size_t length, Utf8Units units = Utf8Units::CodePoints) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(data);
+    size_t start = 0;
+    while (start < length) {
+        size_t end = start + utf8SequenceLength(bytes, length, start);
+        
+        if (units == Utf8Units::Graphemes) {
+            uint32_t previous = utf8Decode(bytes, start, end - start);
+            bool pairedFlag = false;
+            while (end < length) {
+                size_t count = utf8SequenceLength(bytes, length, end);
+                uint32_t next = utf8Decode(bytes, end, count);
+                bool joins = extendsGrapheme(next) || previous == 0x200D
+                             || (previous == '\r' && next == '\n')
+                             || (!pairedFlag && isRegionalIndicator(previous) && isRegionalIndicator(next));
+                if (!joins) {
+                    break;
+                }
+                pairedFlag = pairedFlag || (isRegionalIndicator(previous) && isRegionalIndicator(next));
+                previous = next;
+                end += count;
+            }
+        }
+        
+        swapReversedScalar(data + start, data + end, (end - start) / 2);
+        start = end;
+    }
+    reverseInPlace(data, length);
+}
+
+string reverseUtf8(string str, Utf8Units units = Utf8Units::CodePoints) {
+    reverseUtf8(&str[0], str.size(), units);
+    return str;
+}
+
+// Default window size for reverseFile
+constexpr size_t reverseFileChunkBytes = 16 << 20;
+
+/**
+ * Reverse a file in place, however large, holding at most two chunks at
+ * a time
+ * 
+ * Chunks are paired from both ends of the file: the front chunk and the
+ * back chunk are each reversed and then trade places, and the pairs move
+ * inwards until they meet; whatever is left in the middle is reversed on
+ * its own. Where mmap exists each pair of chunks is mapped as a window
+ * and swapped in place (the page cache writes them back), elsewhere they
+ * are read into buffers and written back.
+ * 
+ * @param path File to reverse
+ * @param chunkBytes Bytes per chunk (rounded up to whole pages)
+ * @throws runtime_error if the file cannot be opened, mapped or written
+ */
+void reverseFile(const string& path, size_t chunkBytes = reverseFileChunkBytes) {
+#if RECURSION_USE_MMAP
+    int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        throw runtime_error("Cannot open file " + path + "!");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw runtime_error("Cannot read the size of " + path + "!");
+    }
+    size_t length = static_cast<size_t>(info.st_size);
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    chunkBytes = max((chunkBytes + page - 1) / page * page, page);
+    
+    // Map [offset, offset + count) (any offset) and call work(bytes)
+    auto withWindow = [&](size_t offset, size_t count, auto work) {
+        size_t aligned = offset / page * page;
+        size_t span = offset - aligned + count;
+        void* mapping = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(aligned));
+        if (mapping == MAP_FAILED) {
+            throw runtime_error("Cannot map file " + path + "!");
+        }
+        try {
+            work(static_cast<char*>(mapping) + (offset - aligned));
+        } catch (...) {
+            munmap(mapping, span);
+            throw;
+        }
+        munmap(mapping, span);
+    };
+    
+    try {
+        size_t front = 0;
+        size_t back = length;
+        while (back - front >= 2 * chunkBytes) {
+            withWindow(front, chunkBytes, [&](char* frontBytes) {
+                withWindow(back - chunkBytes, chunkBytes, [&](char* backBytes) {
+                    swapReversed(frontBytes, backBytes + chunkBytes, chunkBytes);
+                });
+            });
+            front += chunkBytes;
+            back -= chunkBytes;
+        }
+        if (back - front > 1) {
+            withWindow(front, back - front, [&](char* middle) { reverseInPlace(middle, back - front); });
+        }
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+#else
+    fstream file(path, ios::in | ios::out | ios::binary);
+    if (!file) {
+        throw runtime_error("Cannot open file " + path + "!");
+    }
+    file.seekg(0, ios::end);
+    size_t length = static_cast<size_t>(file.tellg());
+    chunkBytes = max(chunkBytes, size_t(1));
+    vector<char> frontBytes(chunkBytes);
+    vector<char> backBytes(chunkBytes);
+    
+    auto readAt = [&](size_t offset, char* bytes, size_t count) {
+        file.seekg(static_cast<streamoff>(offset));
+        file.read(bytes, static_cast<streamsize>(count));
+    };
+    auto writeAt = [&](size_t offset, const char* bytes, size_t count) {
+        file.seekp(static_cast<streamoff>(offset));
+        file.write(bytes, static_cast<streamsize>(count));
+    };
+    
+    size_t front = 0;
+    size_t back = length;
+    while (back - front >= 2 * chunkBytes) {
+        readAt(front, frontBytes.data(), chunkBytes);
+        readAt(back - chunkBytes, backBytes.data(), chunkBytes);
+        swapReversed(frontBytes.data(), backBytes.data() + chunkBytes, chunkBytes);
+        writeAt(front, frontBytes.data(), chunkBytes);
+        writeAt(back - chunkBytes, backBytes.data(), chunkBytes);
+        front += chunkBytes;
+        back -= chunkBytes;
+    }
+    if (back - front > 1) {
+        vector<char> middle(back - front);
+        readAt(front, middle.data(), middle.size());
+        reverseInPlace(middle.data(), middle.size());
+        writeAt(front, middle.data(), middle.size());
+    }
+    if (!file) {
+        throw runtime_error("Failed writing " + path + "!");
+    }
+#endif
+}
+
+// ============================================================================
+// PROBLEM 4: BINARY SEARCH
+// ============================================================================
+
+/**
+ * Recursive binary search implementation
+ * 
+ * BASE CASE: 
+ * - left > right (element not found, return -1)
+ * - arr[mid] == target (element found, return mid)
+ * 
+ * RECURSIVE CASE:
+ * - If target < arr[mid], search left half
+ * - If target > arr[mid], search right half
+ * 
+ * The search space is halved with each recursive call by adjusting
+ * the left or right boundary based on comparison with middle element.
+ * 
+ * @param arr Sorted array to search in
+ * @param target Element to find
+ * @param left Left boundary of search space
+ * @param right Right boundary of search space
+ * @return Index of target element, or -1 if not found
+ */
+int binarySearch(const vector<int>& arr, int target, int left, int right) {
+    // Base case 1: search space is exhausted
+    if (left > right) {
+        return -1;  // Element not found
+    }
+    
+    // Calculate middle index
+    int mid = left + (right - left) / 2;
+    
+    // Base case 2: element found at middle
+    if (arr[mid] == target) {
+        return mid;
+    }
+    
+    // Recursive case 1: target is in left half
+    if (target < arr[mid]) {
+        return binarySearch(arr, target, left, mid - 1);
+    }
+    
+    // Recursive case 2: target is in right half
+    return binarySearch(arr, target, mid + 1, right);
+}
+
+// Wrapper function for easier calling
+// An empty array is a miss straight away; computing arr.size() - 1 on it
+// would wrap around to the largest size_t before being narrowed to int.
+int binarySearch(const vector<int>& arr, int target) {
+    if (arr.empty()) {
+        return -1;
+    }
+    return binarySearch(arr, target, 0, static_cast<int>(arr.size()) - 1);
+}
+
+/**
+ * Recursive binary search over a fixed-size array, usable at compile time
+ * (same logic as the vector version)
+ * 
+ * @param arr Sorted array to search in
+ * @param target Element to find
+ * @param left Left boundary of search space
+ * @param right Right boundary of search space
+ * @return Index of target element, or -1 if not found
+ */
+template <typename T, size_t N>
+constexpr int binarySearch(const array<T, N>& arr, const T& target, int left, int right) {
+    if (left > right) {
+        return -1;
+    }
+    int mid = left + (right - left) / 2;
+    if (arr[mid] == target) {
+        return mid;
+    }
+    if (target < arr[mid]) {
+        return binarySearch(arr, target, left, mid - 1);
+    }
+    return binarySearch(arr, target, mid + 1, right);
+}
+
+// Wrapper for a whole static key set
+template <typename T, size_t N>
+constexpr int binarySearch(const array<T, N>& arr, const T& target) {
+    return binarySearch(arr, target, 0, static_cast<int>(N) - 1);
+}
+
+// A static key set searched by the compiler
+constexpr array<int, 8> staticKeys = {1, 3, 5, 7, 9, 11, 13, 15};
+
+static_assert(binarySearch(staticKeys, 7) == 3, "7 must be found at index 3");
+static_assert(binarySearch(staticKeys, 1) == 0 && binarySearch(staticKeys, 15) == 7, "Ends must be found");
+static_assert(binarySearch(staticKeys, 10) == -1, "10 must not be found");
+static_assert(binarySearch(array<int, 0>{}, 5) == -1, "An empty key set finds nothing");
+
+// ----------------------------------------------------------------------------
+// Cache-friendly search indexes
+// ----------------------------------------------------------------------------
+// Once a sorted array outgrows the cache, the binary search above misses
+// the cache at nearly every level (the middle elements it visits are far
+// apart) and mispredicts half its branches. The indexes below are built
+// once from a sorted vector and lay the keys out in the order a search
+// visits them. find() returns the same index into the sorted vector as
+// binarySearch (for a key that appears more than once it returns the
+// first occurrence, where binarySearch may return any of them).
+
+constexpr size_t cacheLineBytes = 64;
+
+// Number of ints to skip from data to reach a cache line boundary
+inline size_t cacheLineOffset(const int* data) {
+    size_t misalignment = reinterpret_cast<uintptr_t>(data) % cacheLineBytes;
+    return (misalignment == 0) ? 0 : (cacheLineBytes - misalignment) / sizeof(int);
+}
+
+inline void prefetchRead(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#else
+    (void)address;
+#endif
+}
+
+/**
+ * Search index in Eytzinger (breadth-first) order: the root is slot 1 and
+ * the children of slot k are slots 2k and 2k+1, so the top levels of the
+ * tree share a few cache lines and each level down is one multiply away.
+ * The descent has no data-dependent branch, and the cache line four levels
+ * below is prefetched while the current level is compared.
+ */
+class EytzingerIndex {
+private:
+    vector<int> storage;    // Keys, starting on a cache line at `first`
+    vector<int> positions;  // Index in the sorted vector of the key in slot k
+    size_t count;
+    size_t first;
+    
+    int* keys() {
+        return storage.data() + first;
+    }
+    
+    const int* keys() const {
+        return storage.data() + first;
+    }
+    
+    /**
+     * Recursive in-order fill: the left subtree holds the smaller keys,
+     * then this slot, then the right subtree
+     * 
+     * BASE CASE: slot k is past the end of the tree
+     * RECURSIVE CASE: fill 2k, take the next sorted key, fill 2k+1
+     */
+    void build(const vector<int>& sorted, size_t& next, size_t k) {
+        if (k > count) {
+            return;
+        }
+        build(sorted, next, 2 * k);
+        keys()[k] = sorted[next];
+        positions[k] = static_cast<int>(next);
+        next++;
+        build(sorted, next, 2 * k + 1);
+    }
+    
+    // Slot of the first key >= target, or 0 if every key is smaller
+    size_t lowerBoundSlot(int target) const {
+        const int* slots = keys();
+        size_t k = 1;
+        while (k <= count) {
+            // Slots 16k..16k+15 (four levels down) share one cache line
+            prefetchRead(slots + min(16 * k, count));
+            k = 2 * k + (slots[k] < target);
+        }
+        // Each step right appended a 1 bit and each step left a 0: drop
+        // the trailing right steps and the left step before them to get
+        // back to the last slot where the search went left
+        return k >> (__builtin_ctzll(~static_cast<unsigned long long>(k)) + 1);
+    }
+    
+public:
+    explicit EytzingerIndex(const vector<int>& sorted)
+        : storage(sorted.size() + 1 + cacheLineBytes / sizeof(int)), positions(sorted.size() + 1),
+          count(sorted.size()) {
+        // Slots 16k..16k+15 then fall in a single cache line (a copy of
+        // the index keeps working, but may lose the alignment)
+        first = cacheLineOffset(storage.data());
+        size_t next = 0;
+        build(sorted, next, 1);
+    }
+    
+    // Index of the first key >= target in the sorted vector (size() if none)
+    int lowerBound(int target) const {
+        size_t k = lowerBoundSlot(target);
+        return (k == 0) ? static_cast<int>(count) : positions[k];
     }
-    if (n == 1) {
-        return 1;
+    
+    // Index of target in the sorted vector, or -1 if not found
+    int find(int target) const {
+        size_t k = lowerBoundSlot(target);
+        return (k != 0 && keys()[k] == target) ? positions[k] : -1;
     }
     
-    // Recursive case: sum of previous two Fibonacci numbers
-    return fibonacci(n - 1) + fibonacci(n - 2);
-}
+    int size() const {
+        return static_cast<int>(count);
+    }
+};
 
 /**
- * Helper function to generate first n Fibonacci numbers
- * 
- * @param n Number of Fibonacci numbers to generate
- * @return Vector containing the first n Fibonacci numbers
+ * Static B-tree ("S-tree") search index: 16 keys per node fill exactly one
+ * 64-byte cache line, so a search touches one line per level and the tree
+ * is only log17(n) levels deep. Node k's 17 children are nodes 17k+1 to
+ * 17k+17, so no child pointers are stored. Each node is searched with
+ * vector compares that count its keys below the target, which is also the
+ * child to descend into.
  */
-vector<long long> generateFibonacci(int n) {
-    vector<long long> result;
-    for (int i = 0; i < n; i++) {
-        result.push_back(fibonacci(i));
+class STreeIndex {
+private:
+    static constexpr int nodeKeys = 16;
+    
+    vector<int> storage;    // nodeKeys keys per node, from a cache line at `first`
+    vector<int> positions;  // Index in the sorted vector, -1 for padding
+    size_t count;
+    size_t nodes;
+    size_t first;
+    
+    int* keys() {
+        return storage.data() + first;
     }
-    return result;
-}
+    
+    const int* keys() const {
+        return storage.data() + first;
+    }
+    
+    static size_t child(size_t node, int i) {
+        return node * (nodeKeys + 1) + i + 1;
+    }
+    
+    /**
+     * Recursive in-order fill, like EytzingerIndex::build with 17 subtrees
+     * per node (padding keys go last and never compare below a target)
+     */
+    void build(const vector<int>& sorted, size_t& next, size_t node) {
+        if (node >= nodes) {
+            return;
+        }
+        for (int i = 0; i < nodeKeys; i++) {
+            build(sorted, next, child(node, i));
+            size_t slot = node * nodeKeys + i;
+            if (next < sorted.size()) {
+                keys()[slot] = sorted[next];
+                positions[slot] = static_cast<int>(next);
+            } else {
+                keys()[slot] = numeric_limits<int>::max();
+                positions[slot] = -1;
+            }
+            next++;
+        }
+        build(sorted, next, child(node, nodeKeys));
+    }
+    
+    // Number of the node's keys that are below target (0..16)
+    static int countBelow(const int* node, int target) {
+#if defined(__AVX2__)
+        __m256i needle = _mm256_set1_epi32(target);
+        __m256i low = _mm256_cmpgt_epi32(needle, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(node)));
+        __m256i high = _mm256_cmpgt_epi32(needle, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(node + 8)));
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(low)) | (_mm256_movemask_ps(_mm256_castsi256_ps(high)) << 8);
+        return __builtin_popcount(mask);
+#elif defined(__SSE2__)
+        __m128i needle = _mm_set1_epi32(target);
+        int mask = 0;
+        for (int i = 0; i < nodeKeys; i += 4) {
+            __m128i less = _mm_cmpgt_epi32(needle, _mm_loadu_si128(reinterpret_cast<const __m128i*>(node + i)));
+            mask |= _mm_movemask_ps(_mm_castsi128_ps(less)) << i;
+        }
+        return __builtin_popcount(mask);
+#else
+        int below = 0;
+        for (int i = 0; i < nodeKeys; i++) {
+            below += node[i] < target;
+        }
+        return below;
+#endif
+    }
+    
+    // Slot of the first key >= target, or -1 if every key is smaller
+    long long lowerBoundSlot(int target) const {
+        long long best = -1;
+        size_t node = 0;
+        while (node < nodes) {
+            int below = countBelow(keys() + node * nodeKeys, target);
+            if (below < nodeKeys) {
+                // Anything found further down is smaller than this key
+                best = static_cast<long long>(node * nodeKeys + below);
+            }
+            node = child(node, below);
+        }
+        return best;
+    }
+    
+public:
+    explicit STreeIndex(const vector<int>& sorted)
+        : count(sorted.size()), nodes((sorted.size() + nodeKeys - 1) / nodeKeys) {
+        storage.resize(nodes * nodeKeys + cacheLineBytes / sizeof(int));
+        first = cacheLineOffset(storage.data());
+        positions.resize(nodes * nodeKeys);
+        size_t next = 0;
+        build(sorted, next, 0);
+    }
+    
+    // Index of the first key >= target in the sorted vector (size() if none)
+    int lowerBound(int target) const {
+        long long slot = lowerBoundSlot(target);
+        return (slot < 0 || positions[slot] < 0) ? static_cast<int>(count) : positions[slot];
+    }
+    
+    // Index of target in the sorted vector, or -1 if not found
+    int find(int target) const {
+        long long slot = lowerBoundSlot(target);
+        return (slot >= 0 && keys()[slot] == target) ? positions[slot] : -1;
+    }
+    
+    int size() const {
+        return static_cast<int>(count);
+    }
+};
 
-// ============================================================================
-// PROBLEM 3: STRING REVERSAL
-// ============================================================================
+// ----------------------------------------------------------------------------
+// Batched lookups
+// ----------------------------------------------------------------------------
+// One binarySearch call waits for a cache miss at every level before it
+// can pick the next element to load. A batch of independent searches can
+// instead keep a miss in flight for each of several keys at once.
+
+// Searches kept in flight at once by binarySearchBatch
+constexpr int batchSearchLanes = 16;
+
+// Batches smaller than this per thread are searched on the calling thread
+constexpr size_t minParallelBatch = 1 << 15;
+
+// Sorted batches take the merge-style path when their keys are on average
+// no further apart in the array than this; sparser batches gallop further
+// than a plain search would go, and are interleaved instead
+constexpr size_t maxMergeGap = 4096;
 
 /**
- * Recursive function to reverse a string
- * 
- * BASE CASE: Empty string or single character returns itself
- * RECURSIVE CASE: Last character + reverse(remaining string)
- * 
- * The function takes the last character and prepends it to the reversed
- * version of the string without that last character.
- * 
- * @param str The string to reverse
- * @return Reversed string
+ * Search keys[0..count) one step at a time, round-robin over a group of
+ * lanes: each step decides one lane's next probe and prefetches it, and
+ * by the time that lane comes round again the probe is usually in cache.
+ * A lane whose search ends takes the next key. Each search follows exactly
+ * the probes of the recursive binarySearch, so results match it even for
+ * keys that appear more than once.
  */
-string reverseString(string str) {
-    // Base case: empty string or single character
-    if (str.length() <= 1) {
-        return str;
+void binarySearchInterleaved(const vector<int>& arr, const int* keys, int* out, size_t count) {
+    struct Lane {
+        int left;
+        int right;
+        size_t query;
+    };
+    
+    const int* data = arr.data();
+    int last = static_cast<int>(arr.size()) - 1;
+    Lane lanes[batchSearchLanes];
+    int active = 0;
+    size_t next = 0;
+    
+    auto start = [&](Lane& lane) {
+        lane = {0, last, next++};
+        prefetchRead(data + last / 2);
+    };
+    while (active < batchSearchLanes && next < count) {
+        start(lanes[active++]);
     }
     
-    // Recursive case: last character + reverse of remaining string
-    // Take last character and concatenate with reverse of substring
-    return str[str.length() - 1] + reverseString(str.substr(0, str.length() - 1));
+    while (active > 0) {
+        for (int i = 0; i < active; i++) {
+            Lane& lane = lanes[i];
+            int target = keys[lane.query];
+            int result = -2;  // Still searching
+            
+            if (lane.left > lane.right) {
+                result = -1;
+            } else {
+                int mid = lane.left + (lane.right - lane.left) / 2;
+                int value = data[mid];
+                if (value == target) {
+                    result = mid;
+                } else if (target < value) {
+                    lane.right = mid - 1;
+                } else {
+                    lane.left = mid + 1;
+                }
+                if (lane.left <= lane.right) {
+                    prefetchRead(data + lane.left + (lane.right - lane.left) / 2);
+                }
+            }
+            
+            if (result != -2) {
+                out[lane.query] = result;
+                if (next < count) {
+                    start(lane);
+                } else {
+                    lane = lanes[--active];  // Close the gap and revisit slot i
+                    i--;
+                }
+            }
+        }
+    }
 }
 
-// Alternative implementation using first character
-string reverseStringAlt(string str) {
-    // Base case: empty string or single character
-    if (str.length() <= 1) {
-        return str;
+/**
+ * Search sorted keys[0..count) with one forward pass over arr, like a
+ * merge: each key's lower bound is galloped to from the previous one, so
+ * the whole batch costs O(count log(n / count)) and walks arr in order.
+ * Keys found more than once in arr are looked up with binarySearch so the
+ * index returned is the same one it gives.
+ */
+void binarySearchSorted(const vector<int>& arr, const int* keys, int* out, size_t count) {
+    size_t n = arr.size();
+    size_t position = 0;
+    for (size_t q = 0; q < count; q++) {
+        int target = keys[q];
+        
+        // Double the step until it passes the target, then search that step
+        size_t low = position;
+        size_t step = 1;
+        while (low + step < n && arr[low + step] < target) {
+            low += step;
+            step *= 2;
+        }
+        size_t high = min(low + step + 1, n);
+        position = static_cast<size_t>(lower_bound(arr.begin() + low, arr.begin() + high, target) - arr.begin());
+        
+        if (position == n || arr[position] != target) {
+            out[q] = -1;
+        } else if (position + 1 < n && arr[position + 1] == target) {
+            out[q] = binarySearch(arr, target);
+        } else {
+            out[q] = static_cast<int>(position);
+        }
     }
-    
-    // Recursive case: reverse of remaining + first character
-    return reverseStringAlt(str.substr(1)) + str[0];
 }
 
-// ============================================================================
-// PROBLEM 4: BINARY SEARCH
-// ============================================================================
-
 /**
- * Recursive binary search implementation
- * 
- * BASE CASE: 
- * - left > right (element not found, return -1)
- * - arr[mid] == target (element found, return mid)
- * 
- * RECURSIVE CASE:
- * - If target < arr[mid], search left half
- * - If target > arr[mid], search right half
+ * Look up many keys at once; out[i] receives binarySearch(arr, keys[i])
  * 
- * The search space is halved with each recursive call by adjusting
- * the left or right boundary based on comparison with middle element.
+ * Sorted batches dense enough for it (see maxMergeGap) take the
+ * merge-style path, others interleave their searches to overlap cache
+ * misses. Batches of at least minParallelBatch
+ * keys per thread are split into contiguous slices, one per thread (the
+ * calling thread takes the first).
  * 
  * @param arr Sorted array to search in
- * @param target Element to find
- * @param left Left boundary of search space
- * @param right Right boundary of search space
- * @return Index of target element, or -1 if not found
+ * @param keys Elements to find
+ * @param out Resized to keys.size() and filled with indexes or -1
+ * @param threads Threads to use at most (0 for one per hardware thread)
  */
-int binarySearch(const vector<int>& arr, int target, int left, int right) {
-    // Base case 1: search space is exhausted
-    if (left > right) {
-        return -1;  // Element not found
+void binarySearchBatch(const vector<int>& arr, const vector<int>& keys, vector<int>& out, int threads = 0) {
+    out.resize(keys.size());
+    if (arr.empty()) {
+        fill(out.begin(), out.end(), -1);
+        return;
     }
     
-    // Calculate middle index
-    int mid = left + (right - left) / 2;
+    bool merge = keys.size() * maxMergeGap >= arr.size() && is_sorted(keys.begin(), keys.end());
+    auto searchSlice = [&](size_t first, size_t count) {
+        if (merge) {
+            binarySearchSorted(arr, keys.data() + first, out.data() + first, count);
+        } else {
+            binarySearchInterleaved(arr, keys.data() + first, out.data() + first, count);
+        }
+    };
     
-    // Base case 2: element found at middle
-    if (arr[mid] == target) {
-        return mid;
+    size_t segments = keys.size() / minParallelBatch;
+    if (segments >= 2) {
+        // Asking for the thread count is a system call: only pay for it
+        // when the batch is large enough to split
+        if (threads <= 0) {
+            threads = static_cast<int>(max(1u, thread::hardware_concurrency()));
+        }
+        segments = min(segments, static_cast<size_t>(threads));
     }
-    
-    // Recursive case 1: target is in left half
-    if (target < arr[mid]) {
-        return binarySearch(arr, target, left, mid - 1);
+    if (segments < 2) {
+        searchSlice(0, keys.size());
+        return;
     }
     
-    // Recursive case 2: target is in right half
-    return binarySearch(arr, target, mid + 1, right);
+    vector<thread> workers;
+    size_t slice = (keys.size() + segments - 1) / segments;
+    for (size_t first = slice; first < keys.size(); first += slice) {
+        workers.emplace_back(searchSlice, first, min(slice, keys.size() - first));
+    }
+    searchSlice(0, slice);
+    for (thread& worker : workers) {
+        worker.join();
+    }
 }
 
-// Wrapper function for easier calling
-int binarySearch(const vector<int>& arr, int target) {
-    return binarySearch(arr, target, 0, arr.size() - 1);
-}
+
 
 // ============================================================================
 // UTILITY FUNCTIONS
@@ -213,7 +2135,65 @@ void testFactorial() {
     printSubHeader("Edge Cases");
     cout << " Factorial of 0: " << factorial(0) << " (Base case)" << endl;
     cout << " Factorial of 1: " << factorial(1) << " (Base case)" << endl;
-    cout << " Factorial of 20: " << factorial(20) << " (Large number)" << endl;
+    cout << " Factorial of 20: " << factorial(20) << " (Largest that fits in a long long)" << endl;
+    try {
+        factorial(21);
+    } catch (const exception& e) {
+        cout << " Factorial of 21: " << e.what() << endl;
+    }
+    cout << " 21! exact: " << factorialBig(21) << endl;
+    cout << " 50! exact: " << factorialBig(50) << endl;
+    cout << " C(100, 50): " << binomialBig(100, 50) << endl;
+    
+    printSubHeader("Checks Between Methods");
+    bool matches = true;
+    for (int n = 0; n <= maxLongLongFactorial; n++) {
+        matches = matches && factorialBig(n).toString() == to_string(factorial(n));
+    }
+    cout << " factorialBig matches factorial up to n = 20: " << (matches ? "yes" : "no") << endl;
+    cout << " C(1000, 300) * 300! * 700! == 1000!: "
+         << (binomialBig(1000, 300) * factorialBig(300) * factorialBig(700) == factorialBig(1000) ? "yes" : "no")
+         << endl;
+    cout << " Empty ranges multiply to 1: "
+         << (rangeProduct(5, 5) == BigInteger(1) && rangeProduct(100000, 100000) == BigInteger(1) ? "yes" : "no")
+         << endl;
+    cout << " (Run with --bench-factorial for product tree timings)" << endl;
+}
+
+/**
+ * Time the product tree against the naive loop, and on large inputs
+ */
+void benchmarkFactorial() {
+    printHeader("BENCHMARK: PRODUCT TREE VS NAIVE LOOP");
+    auto timeMs = [](auto work) {
+        auto start = chrono::steady_clock::now();
+        work();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    
+    // The naive loop multiplies an ever longer result by one small factor
+    // at a time: n multiplications whose total cost grows with n^2
+    const int compareN = 20000;
+    BigInteger naive(1);
+    double naiveMs = timeMs([&]() {
+        for (int i = 2; i <= compareN; i++) {
+            naive = naive * BigInteger(static_cast<unsigned long long>(i));
+        }
+    });
+    BigInteger tree;
+    double treeMs = timeMs([&]() { tree = factorialBig(compareN); });
+    cout << fixed << setprecision(1);
+    cout << " " << compareN << "! (" << tree.digitCount() << " digits) - naive loop: " << naiveMs
+         << " ms, product tree: " << treeMs << " ms, same result: " << (naive == tree ? "yes" : "no") << endl;
+    
+    const int largeN = 200000;
+    BigInteger large;
+    double largeMs = timeMs([&]() { large = factorialBig(largeN); });
+    BigInteger binomial;
+    double binomialMs = timeMs([&]() { binomial = binomialBig(largeN, largeN / 2); });
+    cout << " " << largeN << "! (" << large.digitCount() << " digits): " << largeMs << " ms" << endl;
+    cout << " C(" << largeN << ", " << largeN / 2 << ") (" << binomial.digitCount() << " digits): "
+         << binomialMs << " ms" << defaultfloat << endl;
 }
 
 /**
@@ -222,10 +2202,11 @@ void testFactorial() {
 void testFibonacci() {
     printHeader("PROBLEM 2: FIBONACCI SEQUENCE");
     
-    cout << "\nRecursive Logic:" << endl;
-    cout << "  Base Case: fib(0) = 0, fib(1) = 1" << endl;
-    cout << "  Recursive Case: fib(n) = fib(n-1) + fib(n-2)" << endl;
-    cout << "  Example: fib(5) = fib(4) + fib(3) = 3 + 2 = 5\n" << endl;
+    cout << "\nRecursive Logic (fast doubling):" << endl;
+    cout << "  Base Case: (fib(0), fib(1)) = (0, 1)" << endl;
+    cout << "  Recursive Case: from (a, b) = (fib(k), fib(k+1)) with k = n / 2" << endl;
+    cout << "    fib(2k) = a * (2b - a), fib(2k+1) = a^2 + b^2" << endl;
+    cout << "  Example: fib(5) from (fib(2), fib(3)) = (1, 2): 1^2 + 2^2 = 5\n" << endl;
     
     // Test cases
     vector<int> testInputs = {0, 1, 5, 10, 15};
@@ -238,11 +2219,12 @@ void testFibonacci() {
             continue;
         }
         
-        vector<long long> fibSeq = generateFibonacci(n);
+        // Stream the terms straight from the lazy sequence
         cout << "Sequence: ";
-        for (size_t i = 0; i < fibSeq.size(); i++) {
-            cout << fibSeq[i];
-            if (i < fibSeq.size() - 1) cout << ", ";
+        const char* separator = "";
+        for (long long value : fibonacciSequence().take(n)) {
+            cout << separator << value;
+            separator = ", ";
         }
         cout << endl;
     }
@@ -251,6 +2233,107 @@ void testFibonacci() {
     cout << " fib(0): " << fibonacci(0) << " (First base case)" << endl;
     cout << " fib(1): " << fibonacci(1) << " (Second base case)" << endl;
     cout << " fib(2): " << fibonacci(2) << " (First recursive call)" << endl;
+    cout << " fib(92): " << fibonacci(92) << " (Largest that fits in a long long)" << endl;
+    try {
+        fibonacci(93);
+    } catch (const exception& e) {
+        cout << " fib(93): " << e.what() << endl;
+    }
+    cout << " fib(93) exact: " << fibonacciBig(93) << endl;
+    cout << " fib(100) exact: " << fibonacciBig(100) << endl;
+    cout << " Last of first 93 generated: " << generateFibonacci(93).back() << endl;
+    
+    printSubHeader("Checks Between Engines");
+    bool matches = true;
+    vector<long long> sequence = generateFibonacci(maxLongLongFibonacci + 1);
+    for (int n = 0; n <= maxLongLongFibonacci; n++) {
+        matches = matches && fibonacci(n) == sequence[n]
+                  && fibonacciBig(n).toString() == to_string(sequence[n])
+                  && fibonacciMod(n, 1000000007ULL) == static_cast<unsigned long long>(sequence[n]) % 1000000007ULL;
+    }
+    cout << " fibonacci, generateFibonacci, fibonacciBig and fibonacciMod agree up to n = 92: "
+         << (matches ? "yes" : "no") << endl;
+    cout << " fib(10^18) mod 1000000007: " << fibonacciMod(1000000000000000000ULL, 1000000007ULL) << endl;
+    
+    // A modulus above 2^63, where sums of residues no longer fit in 64 bits
+    const unsigned long long largeModulus = 18446744073709551557ULL;  // 2^64 - 59
+    cout << " fib(92) mod 2^64-59: " << fibonacciMod(92, largeModulus) << " (expected 7540113804746346429)" << endl;
+    cout << " fibonacciMod(1000, 2^64-59) matches fibonacciBig(1000): "
+         << (fibonacciMod(1000, largeModulus) == fibonacciBig(1000).mod(largeModulus) ? "yes" : "no") << endl;
+    
+    printSubHeader("Lazy Sequences");
+    auto printTerms = [](const string& label, auto&& range) {
+        cout << " " << label << ": ";
+        const char* separator = "";
+        for (const auto& value : range) {
+            cout << separator << value;
+            separator = ", ";
+        }
+        cout << endl;
+    };
+    printTerms("fib(10..14)", fibonacciSequence().skip(10).take(5));
+    printTerms("15! to 20!", factorialSequence().skip(15));
+    cout << " fib(0..19) in chunks of 8:" << endl;
+    for (const vector<long long>& batch : fibonacciSequence().take(20).chunks(8)) {
+        printTerms("  batch of " + to_string(batch.size()), batch);
+    }
+    
+    // Any recurrence can be streamed the same way: here the triangular
+    // numbers 0, 1, 3, 6, ... (n, T(n)) -> (n + 1, T(n) + n + 1)
+    auto triangular = makeRecurrence(
+        pair<long long, long long>(0, 0),
+        [](pair<long long, long long>& state) {
+            state.first++;
+            state.second += state.first;
+        },
+        [](const pair<long long, long long>& state) { return state.second; });
+    printTerms("Triangular numbers", triangular.take(10));
+    
+    // Exact terms far past fib(92), holding only two of them at a time
+    BigInteger streamed;
+    for (const BigInteger& value : fibonacciSequenceBig().skip(9999).take(1)) {
+        streamed = value;
+    }
+    cout << " fib(9999) streamed exactly: " << streamed.digitCount() << " digits, matches fibonacciBig: "
+         << (streamed == fibonacciBig(9999) ? "yes" : "no") << endl;
+    printTerms("25! to 27! exact", factorialSequenceBig().skip(25).take(3));
+    
+#if RECURSION_HAS_COROUTINES
+    printSubHeader("Coroutine Generators");
+    printTerms("fib(10..14)", take(skip(fibonacciGenerator(), 10), 5));
+    printTerms("15! to 20!", skip(factorialGenerator(), 15));
+    for (const vector<long long>& batch : chunks(take(fibonacciGenerator(), 20), 8)) {
+        printTerms("batch of " + to_string(batch.size()), batch);
+    }
+    bool agree = true;
+    auto reference = fibonacciSequenceBig().take(500);
+    auto expected = reference.begin();
+    for (const BigInteger& value : take(fibonacciGeneratorBig(), 500)) {
+        agree = agree && value == *expected;
+        ++expected;
+    }
+    cout << " fibonacciGeneratorBig matches fibonacciSequenceBig for 500 terms: " << (agree ? "yes" : "no") << endl;
+    printTerms("25! to 27! exact", take(skip(factorialGeneratorBig(), 25), 3));
+#else
+    cout << " (Build with -std=c++20 for the coroutine generators)" << endl;
+#endif
+    cout << " (Run with --bench-fibonacci to time the exact fib(10^6))" << endl;
+}
+
+/**
+ * Time the exact fast doubling engine on fib(10^6)
+ */
+void benchmarkFibonacci() {
+    printHeader("BENCHMARK: EXACT FIBONACCI");
+    auto start = chrono::steady_clock::now();
+    BigInteger big = fibonacciBig(1000000);
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    string digits = big.toString();
+    cout << " Computed in " << fixed << setprecision(1) << ms << " ms" << defaultfloat << endl;
+    cout << " Digits: " << big.digitCount() << " (" << digits.substr(0, 10) << "..."
+         << digits.substr(digits.size() - 10) << ")" << endl;
+    cout << " Matches fibonacciMod(10^6, 1000000007): "
+         << (big.mod(1000000007ULL) == fibonacciMod(1000000, 1000000007ULL) ? "yes" : "no") << endl;
 }
 
 /**
@@ -291,8 +2374,115 @@ void testStringReversal() {
     cout << " Empty string: \"" << reverseString("") << "\" (Base case)" << endl;
     cout << " Single character: \"" << reverseString("x") << "\" (Base case)" << endl;
     cout << " Two characters: \"" << reverseString("ab") << "\" (First recursion)" << endl;
+    
+    printSubHeader("Reversal Engine");
+    bool matches = true;
+    for (const string& str : testInputs) {
+        string inPlace = str;
+        reverseInPlace(inPlace);
+        matches = matches && inPlace == reverseString(str);
+    }
+    // Every length around the vector block sizes, in place and into a buffer
+    for (size_t length = 0; length <= 200; length++) {
+        string text(length, ' ');
+        for (size_t i = 0; i < length; i++) {
+            text[i] = static_cast<char>('a' + (i * 7) % 26);
+        }
+        string expected(text.rbegin(), text.rend());
+        string inPlace = text;
+        reverseInPlace(inPlace);
+        string copy(length, ' ');
+        reverseInto(text.data(), length, &copy[0]);
+        matches = matches && inPlace == expected && copy == expected;
+    }
+    cout << " reverseInPlace and reverseInto match the recursive version: " << (matches ? "yes" : "no") << endl;
+    cout << " Vector block size: " << reverseBlockBytes << " bytes" << (reverseBlockBytes == 0 ? " (scalar build)" : "")
+         << endl;
+    
+    printSubHeader("UTF-8 Aware Reversal");
+    string accented = "h\xC3\xA9llo w\xC3\xB6rld";                       // "héllo wörld"
+    string combining = "cafe\xCC\x81!";                                   // "café!" with a combining accent
+    string emoji = "\xF0\x9F\x91\x8D\xF0\x9F\x8F\xBD \xF0\x9F\x87\xB3\xF0\x9F\x87\xAC";  // thumbs up + skin tone, flag
+    cout << " By code point: " << accented << " -> " << reverseUtf8(accented) << endl;
+    cout << " By code point: " << combining << " -> " << reverseUtf8(combining)
+         << " (accent moves to the '!')" << endl;
+    cout << " By grapheme:   " << combining << " -> " << reverseUtf8(combining, Utf8Units::Graphemes) << endl;
+    cout << " By grapheme:   " << emoji << " -> " << reverseUtf8(emoji, Utf8Units::Graphemes) << endl;
+    cout << " Reversing twice restores the text: "
+         << (reverseUtf8(reverseUtf8(emoji, Utf8Units::Graphemes), Utf8Units::Graphemes) == emoji ? "yes" : "no")
+         << endl;
+    cout << " (Run with --bench-reverse for large buffer and file reversal timings)" << endl;
+}
+
+/**
+ * Time the reversal engine on large buffers and reverse a file on disk
+ */
+void benchmarkReversal() {
+    printHeader("BENCHMARK: STRING REVERSAL");
+    auto timeMs = [](auto work) {
+        auto start = chrono::steady_clock::now();
+        work();
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    };
+    cout << fixed << setprecision(2);
+    
+    // The recursive version copies the rest of the string at every level
+    string small(4000, 'x');
+    double recursiveMs = timeMs([&]() { small = reverseString(small); });
+    double engineSmallMs = timeMs([&]() { reverseInPlace(small); });
+    cout << " 4000 bytes - recursive: " << recursiveMs << " ms, reverseInPlace: " << engineSmallMs << " ms" << endl;
+    
+    const size_t bufferBytes = 64 << 20;
+    string buffer(bufferBytes, ' ');
+    for (size_t i = 0; i < bufferBytes; i++) {
+        buffer[i] = static_cast<char>(i * 131 + (i >> 12));
+    }
+    string original = buffer;
+    double scalarMs = timeMs([&]() { reverseInPlaceScalar(&buffer[0], bufferBytes); });
+    double vectorMs = timeMs([&]() { reverseInPlace(&buffer[0], bufferBytes); });
+    double parallelMs = timeMs([&]() { reverseParallel(&buffer[0], bufferBytes); });
+    double mb = bufferBytes / 1048576.0;
+    cout << " 64 MB - scalar: " << scalarMs << " ms (" << mb / scalarMs * 1000 << " MB/s), vector: " << vectorMs
+         << " ms (" << mb / vectorMs * 1000 << " MB/s), parallel: " << parallelMs << " ms ("
+         << mb / parallelMs * 1000 << " MB/s)" << endl;
+    cout << defaultfloat;
+    // Three reversals leave the buffer reversed once
+    cout << " Results agree: " << (equal(buffer.begin(), buffer.end(), original.rbegin()) ? "yes" : "no") << endl;
+    
+    printSubHeader("Streaming File Reversal");
+    // The scratch file lives in the temp directory and is removed on the
+    // way out, even when a step throws
+    struct ScratchFile {
+        string path;
+        ~ScratchFile() {
+            error_code ignored;
+            filesystem::remove(path, ignored);
+        }
+    };
+    ScratchFile scratch{(filesystem::temp_directory_path()
+                         / ("reverse_test_" + to_string(chrono::steady_clock::now().time_since_epoch().count())
+                            + ".bin")).string()};
+    
+    // Small chunks so the file takes many window pairs plus a middle piece
+    const size_t fileBytes = (8 << 20) + 12345;
+    {
+        ofstream file(scratch.path, ios::binary);
+        file.write(buffer.data(), fileBytes);
+        if (!file) {
+            throw runtime_error("Cannot write " + scratch.path + "!");
+        }
+    }
+    reverseFile(scratch.path, 64 << 10);
+    string reversedFile(fileBytes, ' ');
+    {
+        ifstream file(scratch.path, ios::binary);
+        file.read(&reversedFile[0], fileBytes);
+    }
+    cout << " " << fileBytes << " bytes in 64 KB chunks matches reversing in memory: "
+         << (equal(reversedFile.begin(), reversedFile.end(), buffer.rend() - fileBytes) ? "yes" : "no") << endl;
 }
 
+
 /**
  * Test binary search with various inputs including edge cases
  */
@@ -383,13 +2573,373 @@ void testBinarySearch() {
     cout << " First element: Found at index 0" << endl;
     cout << " Last element: Found at last index" << endl;
     cout << " Element not in array: Returns -1" << endl;
+    
+    printSubHeader("Search Indexes");
+    // Every size around the node and cache line widths, with and without
+    // duplicate keys, against binarySearch and std::lower_bound
+    bool matches = true;
+    unsigned seed = 24;
+    for (int n = 0; n <= 300; n++) {
+        for (int spread : {1, 3}) {
+            vector<int> sorted(n);
+            for (int i = 0; i < n; i++) {
+                seed = seed * 1103515245u + 12345u;
+                sorted[i] = (spread == 1) ? i * 2 : static_cast<int>(seed >> 20) % (n * spread + 1);
+            }
+            sort(sorted.begin(), sorted.end());
+            EytzingerIndex eytzinger(sorted);
+            STreeIndex stree(sorted);
+            for (int target = -1; target <= 2 * n + 1; target++) {
+                int expected = static_cast<int>(lower_bound(sorted.begin(), sorted.end(), target) - sorted.begin());
+                bool present = expected < n && sorted[expected] == target;
+                int found = binarySearch(sorted, target);
+                matches = matches && eytzinger.lowerBound(target) == expected && stree.lowerBound(target) == expected
+                          && eytzinger.find(target) == (present ? expected : -1)
+                          && stree.find(target) == (present ? expected : -1)
+                          && (found == -1) == !present && (!present || sorted[found] == target);
+            }
+        }
+    }
+    vector<int> extremes = {numeric_limits<int>::min(), 0, numeric_limits<int>::max()};
+    STreeIndex extremeTree(extremes);
+    EytzingerIndex extremeEytzinger(extremes);
+    matches = matches && extremeTree.find(numeric_limits<int>::max()) == 2
+              && extremeEytzinger.find(numeric_limits<int>::max()) == 2
+              && extremeTree.find(numeric_limits<int>::min()) == 0 && STreeIndex(arr1).find(numeric_limits<int>::max()) == -1;
+    cout << " EytzingerIndex and STreeIndex agree with binarySearch and lower_bound: " << (matches ? "yes" : "no")
+         << endl;
+    
+    cout << " (Run with --bench-search [maxSize] for the index size sweep)" << endl;
+    
+    printSubHeader("Batched Lookups");
+    // Arrays with many duplicates, where binarySearch's exact index matters
+    bool batchMatches = true;
+    for (int n : {0, 1, 5, 100, 5000}) {
+        vector<int> sorted(n);
+        for (int i = 0; i < n; i++) {
+            seed = seed * 1103515245u + 12345u;
+            sorted[i] = static_cast<int>(seed >> 22) % (n + 1);
+        }
+        sort(sorted.begin(), sorted.end());
+        
+        vector<int> keys(100000);
+        for (int& key : keys) {
+            seed = seed * 1103515245u + 12345u;
+            key = static_cast<int>(seed >> 20) % (n + 3) - 1;
+        }
+        for (bool sortKeys : {false, true}) {
+            if (sortKeys) {
+                sort(keys.begin(), keys.end());
+            }
+            for (int threads : {1, 4}) {
+                vector<int> out;
+                binarySearchBatch(sorted, keys, out, threads);
+                for (size_t i = 0; i < keys.size(); i++) {
+                    batchMatches = batchMatches && out[i] == binarySearch(sorted, keys[i]);
+                }
+            }
+        }
+    }
+    cout << " binarySearchBatch matches binarySearch key for key: " << (batchMatches ? "yes" : "no") << endl;
+    cout << " (Run with --bench-batch [arraySize] for batched lookup throughput)" << endl;
+}
+
+/**
+ * Lookups per second for binarySearch called once per key against
+ * binarySearchBatch, for batches of different sizes (and the same keys
+ * sorted first, for the merge-style path) on an array of arraySize keys
+ */
+void benchmarkBatchSearch(int arraySize) {
+    printSubHeader("Benchmark: Batched Lookups (" + to_string(arraySize) + " keys in the array)");
+    vector<int> sorted(arraySize);
+    for (int i = 0; i < arraySize; i++) {
+        sorted[i] = 2 * i;
+    }
+    
+    const size_t totalLookups = 1 << 21;
+    vector<int> queries(totalLookups);
+    unsigned seed = 25;
+    for (int& query : queries) {
+        seed = seed * 1103515245u + 12345u;
+        query = static_cast<int>(((static_cast<unsigned long long>(seed) << 15) ^ (seed >> 7)) % (2ULL * arraySize));
+    }
+    
+    cout << right << setw(10) << "batch" << setw(14) << "one by one" << setw(14) << "batched"
+         << setw(14) << "sorted batch" << "   (million lookups/s)" << endl;
+    for (size_t batchSize : {size_t(1), size_t(16), size_t(256), size_t(4096), size_t(65536), totalLookups}) {
+        // The same lookups, cut into batches of batchSize
+        vector<vector<int>> batches;
+        for (size_t first = 0; first < totalLookups; first += batchSize) {
+            batches.emplace_back(queries.begin() + first, queries.begin() + first + batchSize);
+        }
+        vector<vector<int>> sortedBatches = batches;
+        for (vector<int>& batch : sortedBatches) {
+            sort(batch.begin(), batch.end());
+        }
+        
+        auto rate = [&](auto run) {
+            auto start = chrono::steady_clock::now();
+            long long checksum = run();
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            return make_pair(totalLookups / seconds / 1e6, checksum);
+        };
+        auto single = rate([&]() {
+            long long sum = 0;
+            for (const vector<int>& batch : batches) {
+                for (int key : batch) {
+                    sum += binarySearch(sorted, key);
+                }
+            }
+            return sum;
+        });
+        vector<int> out;
+        auto batched = rate([&]() {
+            long long sum = 0;
+            for (const vector<int>& batch : batches) {
+                binarySearchBatch(sorted, batch, out);
+                for (int index : out) {
+                    sum += index;
+                }
+            }
+            return sum;
+        });
+        auto sortedRun = rate([&]() {
+            long long sum = 0;
+            for (const vector<int>& batch : sortedBatches) {
+                binarySearchBatch(sorted, batch, out);
+                for (int index : out) {
+                    sum += index;
+                }
+            }
+            return sum;
+        });
+        
+        cout << fixed << setprecision(2) << setw(10) << batchSize << setw(14) << single.first << setw(14)
+             << batched.first << setw(14) << sortedRun.first
+             << (single.second == batched.second && single.second == sortedRun.second ? "" : "   MISMATCH")
+             << defaultfloat << endl;
+    }
+}
+
+/**
+ * Time binarySearch against the two search indexes on sorted arrays of
+ * 10^3 up to maxSize keys (each ten times the last)
+ * 
+ * Keys are the even numbers, so about half the queries miss. The indexes
+ * are built one at a time to keep peak memory at about 12 bytes per key.
+ */
+void benchmarkSearchIndexes(long long maxSize) {
+    printSubHeader("Benchmark: Search Indexes vs Recursive binarySearch");
+    const int queries = 1000000;
+    vector<int> targets(queries);
+    
+    cout << right << setw(12) << "keys" << setw(16) << "binarySearch" << setw(14) << "lower_bound"
+         << setw(12) << "Eytzinger" << setw(10) << "S-tree" << "   (ns/query)" << endl;
+    for (long long size = 1000; size <= maxSize; size *= 10) {
+        int n = static_cast<int>(min<long long>(size, numeric_limits<int>::max() / 2));
+        vector<int> sorted(n);
+        for (int i = 0; i < n; i++) {
+            sorted[i] = 2 * i;
+        }
+        unsigned seed = 7;
+        for (int& target : targets) {
+            seed = seed * 1103515245u + 12345u;
+            target = static_cast<int>(((static_cast<unsigned long long>(seed) << 15) ^ (seed >> 7)) % (2ULL * n));
+        }
+        
+        // Each run adds up the answers so the results can be compared
+        auto timeNs = [&](auto search, long long& checksum) {
+            auto start = chrono::steady_clock::now();
+            for (int target : targets) {
+                checksum += search(target);
+            }
+            return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / queries;
+        };
+        long long recursiveSum = 0;
+        long long stdSum = 0;
+        long long eytzingerSum = 0;
+        long long streeSum = 0;
+        double recursiveNs = timeNs([&](int target) { return binarySearch(sorted, target); }, recursiveSum);
+        double stdNs = timeNs([&](int target) {
+            auto it = lower_bound(sorted.begin(), sorted.end(), target);
+            return (it != sorted.end() && *it == target) ? static_cast<int>(it - sorted.begin()) : -1;
+        }, stdSum);
+        double eytzingerNs;
+        {
+            EytzingerIndex index(sorted);
+            eytzingerNs = timeNs([&](int target) { return index.find(target); }, eytzingerSum);
+        }
+        double streeNs;
+        {
+            STreeIndex index(sorted);
+            streeNs = timeNs([&](int target) { return index.find(target); }, streeSum);
+        }
+        
+        bool agree = recursiveSum == stdSum && recursiveSum == eytzingerSum && recursiveSum == streeSum;
+        cout << fixed << setprecision(1) << setw(12) << n << setw(16) << recursiveNs << setw(14) << stdNs
+             << setw(12) << eytzingerNs << setw(10) << streeNs << (agree ? "" : "   MISMATCH") << defaultfloat
+             << endl;
+    }
+}
+
+/**
+ * Test the compile-time versions and time the lookup tables against the
+ * runtime recursive functions
+ */
+void testCompileTimeTables() {
+    printHeader("COMPILE-TIME TABLES AND CONSTEXPR KERNELS");
+    
+    // Each of these is worked out by the compiler
+    constexpr long long factorial20 = factorial(20);
+    constexpr long long fibonacci40 = fibonacci(40);
+    constexpr auto reversed = reverseLiteral("recursion");
+    constexpr int position = binarySearch(staticKeys, 11);
+    
+    cout << "\nConstant Arguments:" << endl;
+    cout << " factorial(20): " << factorial20 << endl;
+    cout << " fibonacci(40): " << fibonacci40 << endl;
+#if defined(__cpp_consteval)
+    cout << " fibonacciConstant(92): " << fibonacciConstant(92) << endl;
+#endif
+    cout << " reverseLiteral(\"recursion\"): " << reversed.data() << endl;
+    cout << " binarySearch(staticKeys, 11): " << position << endl;
+    cout << " Table sizes: " << factorialTable.size() << " factorials, "
+         << fibonacciTable.size() << " Fibonacci numbers" << endl;
+    
+    printSubHeader("Checked Lookups");
+    cout << " factorialLookup(15): " << factorialLookup(15) << endl;
+    cout << " fibonacciLookup(80): " << fibonacciLookup(80) << endl;
+    try {
+        factorialLookup(21);
+    } catch (const exception& e) {
+        cout << " factorialLookup(21): " << e.what() << endl;
+    }
+    try {
+        fibonacciLookup(-1);
+    } catch (const exception& e) {
+        cout << " fibonacciLookup(-1): " << e.what() << endl;
+    }
+    cout << " (Run with --bench-tables to time table lookups against recursion)" << endl;
+}
+
+/**
+ * Time the compile-time tables against the runtime recursive functions
+ */
+void benchmarkTables() {
+    printHeader("BENCHMARK: TABLE LOOKUP VS RUNTIME RECURSION");
+    // Arguments come from memory so the compiler cannot fold the calls
+    const int calls = 5000000;
+    vector<int> arguments(calls);
+    unsigned seed = 22;
+    for (int& argument : arguments) {
+        seed = seed * 1103515245u + 12345u;
+        argument = static_cast<int>((seed >> 16) % 1000);
+    }
+    
+    auto measure = [&](const string& name, int limit, auto runtime, auto lookup) {
+        auto timeNs = [&](auto function, unsigned long long& sum) {
+            auto start = chrono::steady_clock::now();
+            for (int argument : arguments) {
+                sum += static_cast<unsigned long long>(function(argument % (limit + 1)));
+            }
+            return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / calls;
+        };
+        unsigned long long runtimeSum = 0;
+        unsigned long long lookupSum = 0;
+        double runtimeNs = timeNs(runtime, runtimeSum);
+        double lookupNs = timeNs(lookup, lookupSum);
+        cout << fixed << setprecision(2) << " " << left << setw(12) << name << right
+             << " recursive: " << setw(7) << runtimeNs << " ns/call, table: " << setw(5) << lookupNs
+             << " ns/call (" << setprecision(0) << runtimeNs / max(lookupNs, 0.01) << "x), same results: "
+             << (runtimeSum == lookupSum ? "yes" : "no") << defaultfloat << endl;
+    };
+    measure("factorial", maxLongLongFactorial,
+            [](int n) { return factorial(n); },
+            [](int n) { return factorialLookup(n); });
+    measure("fibonacci", maxLongLongFibonacci,
+            [](int n) { return fibonacci(n); },
+            [](int n) { return fibonacciLookup(n); });
 }
 
 // ============================================================================
 // MAIN FUNCTION
 // ============================================================================
 
-int main() {
+// Pass --bench-factorial to time the factorial product tree,
+// --bench-fibonacci to time the exact fib(10^6), --bench-tables to time
+// the compile-time tables against recursion, --bench-reverse to time
+// reversal of large buffers and a scratch file in the temp directory,
+// --bench-search [maxSize] to sweep the search index benchmark from
+// 10^3 keys up to maxSize (10^7 by default; at most 10^9, which needs
+// about 12 GB of memory), or
+// --bench-batch [arraySize] to time batched lookups (2^22 keys by default)
+int main(int argc, char* argv[]) {
+    // stoll and friends report bad numbers as invalid_argument or
+    // out_of_range naming only themselves, so say which value it was
+    auto parse = [](const string& option, const string& value, auto convert) {
+        try {
+            return convert(value);
+        } catch (const logic_error&) {
+            throw runtime_error("Invalid value " + value + " for " + option + "!");
+        }
+    };
+    
+    if (argc > 1 && string(argv[1]) == "--bench-factorial") {
+        benchmarkFactorial();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-fibonacci") {
+        benchmarkFibonacci();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-reverse") {
+        try {
+            benchmarkReversal();
+        } catch (const exception& e) {
+            cout << "\n Error: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-tables") {
+        benchmarkTables();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-search") {
+        try {
+            long long maxSize = 10000000LL;
+            if (argc > 2) {
+                maxSize = parse("the sweep size", argv[2], [](const string& v) { return stoll(v); });
+            }
+            // The sweep starts at 10^3 keys and the arrays are indexed by int
+            if (maxSize < 1000 || maxSize > 1000000000LL) {
+                throw runtime_error("The sweep size must be between 1000 and 1000000000!");
+            }
+            benchmarkSearchIndexes(maxSize);
+        } catch (const exception& e) {
+            cout << "\n Error: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--bench-batch") {
+        try {
+            int arraySize = 1 << 22;
+            if (argc > 2) {
+                arraySize = parse("the array size", argv[2], [](const string& v) { return stoi(v); });
+            }
+            // The keys are 2 * i, which has to fit in an int
+            if (arraySize < 1 || arraySize > (1 << 30)) {
+                throw runtime_error("The array size must be between 1 and 1073741824!");
+            }
+            benchmarkBatchSearch(arraySize);
+        } catch (const exception& e) {
+            cout << "\n Error: " << e.what() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    
     cout << "\n";
     cout << "||=============================================================||" << endl;
     cout << "||          RECURSIVE PROBLEM SOLVING IN C++                   ||" << endl;
@@ -402,6 +2952,7 @@ int main() {
         testFibonacci();
         testStringReversal();
         testBinarySearch();
+        testCompileTimeTables();
         
         // Final summary
         printHeader("RECURSION VS ITERATION - COMPARISON SUMMARY");
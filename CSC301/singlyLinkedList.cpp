@@ -1,341 +1,7241 @@
+// Build: g++ -std=c++17 -O2 -pthread singlyLinkedList.cpp -o singlyLinkedList
+// (add -DLIST_METRICS=1 for per-operation counters and latency histograms)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <forward_list>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <random>
+#include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Snapshots are memory-mapped where POSIX mmap exists, read with stdio
+// elsewhere
+#if defined(__unix__) || defined(__APPLE__)
+#define SNAPSHOT_USE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#define SNAPSHOT_USE_MMAP 0
+#endif
 
 using namespace std;
 
-// Node structure representing each element in the linked list
-struct Node {
-    int data;
-    Node* next;
+// ============================================================================
+// OUTPUT AND EVENT SINKS
+// ============================================================================
+
+// Stream buffer that collects output in one large block and hands it to the
+// C library in a single write once the block fills up (or on flush).
+// Lines end with '\n' instead of endl so nothing forces an early flush.
+class BlockOutputBuffer : public streambuf {
+private:
+    static constexpr size_t blockSize = 1 << 16;  // 64 KB per write
+    
+    vector<char> block;
+    FILE* file;
+    
+    // Write out everything buffered so far
+    bool writeBlock() {
+        size_t pending = pptr() - pbase();
+        if (pending > 0) {
+            if (fwrite(pbase(), 1, pending, file) != pending) {
+                return false;
+            }
+            setp(block.data(), block.data() + block.size());
+        }
+        return fflush(file) == 0;
+    }
+    
+protected:
+    // Called when the block is full
+    int_type overflow(int_type ch) override {
+        if (!writeBlock()) {
+            return traits_type::eof();
+        }
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+    
+    // Called on flush()
+    int sync() override {
+        return writeBlock() ? 0 : -1;
+    }
+    
+public:
+    explicit BlockOutputBuffer(FILE* target) : block(blockSize), file(target) {
+        setp(block.data(), block.data() + block.size());
+    }
     
-    // Constructor for easy node creation
-    Node(int value) : data(value), next(nullptr) {}
+    ~BlockOutputBuffer() override {
+        writeBlock();
+    }
 };
 
-// LinkedList class to manage all operations
-class LinkedList {
+// All program output goes through this block-buffered stream
+BlockOutputBuffer outputBuffer(stdout);
+ostream output(&outputBuffer);
+
+// Detects whether a value can be written to an ostream with <<
+template <typename T, typename = void>
+struct IsPrintable : false_type {};
+
+template <typename T>
+struct IsPrintable<T, void_t<decltype(declval<ostream&>() << declval<const T&>())>> : true_type {};
+
+// Write a value if it supports <<, otherwise a placeholder
+template <typename T>
+void printValue(ostream& os, const T& value) {
+    if constexpr (IsPrintable<T>::value) {
+        os << value;
+    } else {
+        os << "<value>";
+    }
+}
+
+// Operations a list reports to its event sink
+enum class ListEvent {
+    InsertedAtBeginning,
+    InsertedAtEnd,
+    InsertedIntoEmpty,
+    InsertedAtPosition,
+    DeletedAtPosition,
+    DeletedValue,
+    Count  // Number of event kinds
+};
+
+// Sink that ignores every event; calls to it compile away entirely
+struct NullSink {
+    template <typename T>
+    void record(ListEvent, const T&, int) {}
+};
+
+// Sink that renders each event as a line of text on a buffered stream
+class BufferedTextSink {
 private:
-    Node* head;  // Pointer to the first node
-    int size;    // Track the number of nodes
+    ostream* stream;
     
 public:
-    // Constructor initializes empty list
-    LinkedList() : head(nullptr), size(0) {}
+    explicit BufferedTextSink(ostream& target = output) : stream(&target) {}
     
-    // Destructor to free all allocated memory
-    ~LinkedList() {
-        clear();
+    template <typename T>
+    void record(ListEvent event, const T& value, int position) {
+        ostream& os = *stream;
+        switch (event) {
+            case ListEvent::InsertedAtBeginning:
+                os << " Inserted ";
+                printValue(os, value);
+                os << " at the beginning.\n";
+                break;
+            case ListEvent::InsertedAtEnd:
+                os << "Inserted ";
+                printValue(os, value);
+                os << " at the end.\n";
+                break;
+            case ListEvent::InsertedIntoEmpty:
+                os << "Inserted ";
+                printValue(os, value);
+                os << " at the end (empty list).\n";
+                break;
+            case ListEvent::InsertedAtPosition:
+                os << " Inserted ";
+                printValue(os, value);
+                os << " at position " << position << ".\n";
+                break;
+            case ListEvent::DeletedAtPosition:
+                // Only deletions from the head are printed with a leading space
+                os << (position == 0 ? " Deleted" : "Deleted") << " node with value ";
+                printValue(os, value);
+                os << " from position " << position << ".\n";
+                break;
+            case ListEvent::DeletedValue:
+                os << "Deleted node with value ";
+                printValue(os, value);
+                os << ".\n";
+                break;
+            case ListEvent::Count:
+                break;
+        }
     }
+};
+
+// Sink that only counts how many times each event happened
+class CountingSink {
+private:
+    long long counts[static_cast<int>(ListEvent::Count)] = {};
     
-    // Add node at the beginning of the list
-    void insertAtBeginning(int value) {
-        Node* newNode = new Node(value);
-        newNode->next = head;
-        head = newNode;
-        size++;
-        cout << " Inserted " << value << " at the beginning." << endl;
+public:
+    template <typename T>
+    void record(ListEvent event, const T&, int) {
+        counts[static_cast<int>(event)]++;
     }
     
-    // Add node at the end of the list
-    void insertAtEnd(int value) {
-        Node* newNode = new Node(value);
-        
-        // If list is empty, new node becomes head
-        if (head == nullptr) {
-            head = newNode;
-            size++;
-            cout << "Inserted " << value << " at the end (empty list)." << endl;
-            return;
-        }
-        
-        // Traverse to the last node
-        Node* temp = head;
-        while (temp->next != nullptr) {
-            temp = temp->next;
-        }
-        
-        temp->next = newNode;
-        size++;
-        cout << "Inserted " << value << " at the end." << endl;
+    long long count(ListEvent event) const {
+        return counts[static_cast<int>(event)];
     }
     
-    // Add node at a specific position (0-indexed)
-    void insertAtMiddle(int value, int position) {
-        // Validate position
-        if (position < 0 || position > size) {
-            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size));
+    long long total() const {
+        long long sum = 0;
+        for (long long c : counts) {
+            sum += c;
         }
-        
-        // If position is 0, insert at beginning
-        if (position == 0) {
-            insertAtBeginning(value);
-            return;
-        }
-        
-        // If position equals size, insert at end
-        if (position == size) {
-            insertAtEnd(value);
-            return;
+        return sum;
+    }
+};
+
+// ============================================================================
+// LIST METRICS
+// ============================================================================
+
+// Build with -DLIST_METRICS=1 to have every LinkedList count the nodes each
+// operation visits, the allocations, frees and failures per operation, keep a
+// latency histogram per operation and track the size high-water mark. With
+// the default of 0 all of it compiles away and the hot paths are unchanged.
+#ifndef LIST_METRICS
+#define LIST_METRICS 0
+#endif
+
+#if LIST_METRICS
+#define LIST_METRICS_ONLY(...) __VA_ARGS__
+#define LIST_METRICS_SCOPE(op) MetricsScope metricsScope(metrics, ListOp::op, size)
+#else
+#define LIST_METRICS_ONLY(...)
+#define LIST_METRICS_SCOPE(op) do {} while (0)
+#endif
+
+// Log-linear latency histogram: exact buckets below 16 ns, then four
+// buckets per power of two, so any percentile is within 25% of the truth.
+// Recording is a bit scan and an increment.
+class LatencyHistogram {
+private:
+    static constexpr int linearBuckets = 16;
+    static constexpr int subBuckets = 4;
+    static constexpr int maxExponent = 40;  // Anything over ~18 minutes shares the last bucket
+    static constexpr int bucketCount = linearBuckets + (maxExponent - 4) * subBuckets;
+    
+    uint64_t buckets[bucketCount] = {};
+    uint64_t samples = 0;
+    uint64_t largest = 0;
+    
+    static int bucketFor(uint64_t nanos) {
+        if (nanos < linearBuckets) {
+            return static_cast<int>(nanos);
         }
-        
-        // Traverse to the node before the insertion point
-        Node* temp = head;
-        for (int i = 0; i < position - 1; i++) {
-            temp = temp->next;
+        int exponent = 63 - __builtin_clzll(nanos);
+        if (exponent >= maxExponent) {
+            return bucketCount - 1;
         }
-        
-        // Create new node and link it
-        Node* newNode = new Node(value);
-        newNode->next = temp->next;
-        temp->next = newNode;
-        size++;
-        cout << " Inserted " << value << " at position " << position << "." << endl;
+        int sub = static_cast<int>((nanos >> (exponent - 2)) & (subBuckets - 1));
+        return linearBuckets + (exponent - 4) * subBuckets + sub;
     }
     
-    // Delete node by position (0-indexed)
-    void deleteByPosition(int position) {
-        // Check if list is empty
-        if (head == nullptr) {
-            throw runtime_error("Cannot delete from an empty list!");
-        }
-        
-        // Validate position
-        if (position < 0 || position >= size) {
-            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size - 1));
+    // Largest value that falls in `bucket`
+    static uint64_t upperBound(int bucket) {
+        if (bucket < linearBuckets) {
+            return static_cast<uint64_t>(bucket);
         }
-        
-        Node* temp = head;
-        
-        // If deleting the first node
-        if (position == 0) {
-            head = head->next;
-            cout << " Deleted node with value " << temp->data << " from position 0." << endl;
-            delete temp;
-            size--;
-            return;
+        int exponent = 4 + (bucket - linearBuckets) / subBuckets;
+        int sub = (bucket - linearBuckets) % subBuckets;
+        uint64_t step = uint64_t(1) << (exponent - 2);
+        return (uint64_t(1) << exponent) + (sub + 1) * step - 1;
+    }
+    
+public:
+    void record(uint64_t nanos) {
+        buckets[bucketFor(nanos)]++;
+        samples++;
+        largest = max(largest, nanos);
+    }
+    
+    uint64_t count() const {
+        return samples;
+    }
+    
+    uint64_t maximum() const {
+        return largest;
+    }
+    
+    // Latency that `fraction` (0..1) of the samples did not exceed
+    uint64_t percentile(double fraction) const {
+        if (samples == 0) {
+            return 0;
         }
-        
-        // Traverse to the node before the one to delete
-        for (int i = 0; i < position - 1; i++) {
-            temp = temp->next;
+        uint64_t rank = static_cast<uint64_t>(fraction * samples);
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < bucketCount; bucket++) {
+            seen += buckets[bucket];
+            if (seen > rank) {
+                return min(upperBound(bucket), largest);
+            }
         }
-        
-        Node* nodeToDelete = temp->next;
-        temp->next = nodeToDelete->next;
-        cout << "Deleted node with value " << nodeToDelete->data << " from position " << position << "." << endl;
-        delete nodeToDelete;
-        size--;
+        return largest;
+    }
+};
+
+#if LIST_METRICS
+// Operations that metrics are kept for (wrappers such as insertAtEnd are
+// counted under the operation they forward to)
+enum class ListOp {
+    InsertAtBeginning,
+    InsertAtEnd,
+    InsertAtPosition,
+    SortedInsert,
+    BatchInsert,  // appendRange, assign, insertAtPositions
+    DeleteAtPosition,
+    DeleteByValue,
+    BatchDelete,  // removeIf, deleteAllByValue, deleteValues, deletePositions
+    At,
+    Search,       // contains, count
+    Sort,         // sort, parallelSort, merge (nodes visited are not counted)
+    Display,
+    Clear,
+    Compact,      // compact, compactStep
+    Splice,       // splice, spliceRange, splitAt, concat
+    Count  // Number of operations
+};
+
+const char* listOpName(ListOp op) {
+    static const char* const names[] = {
+        "insertAtBeginning", "insertAtEnd", "insertAtPosition", "sortedInsert", "batchInsert",
+        "deleteAtPosition", "deleteByValue", "batchDelete", "at", "search", "sort", "display", "clear", "compact", "splice"};
+    return names[static_cast<int>(op)];
+}
+
+// Counters for one operation
+struct OpMetrics {
+    long long calls = 0;
+    long long nodesVisited = 0;
+    long long allocations = 0;
+    long long frees = 0;
+    long long failures = 0;  // Calls that threw or returned a status other than Ok
+    LatencyHistogram latency;
+};
+
+// Everything a list has measured since it was created or last reset
+class ListMetrics {
+private:
+    OpMetrics ops[static_cast<int>(ListOp::Count)];
+    ListOp active = ListOp::Count;  // Outermost operation in progress
+    int highWater = 0;
+    
+    friend class MetricsScope;
+    
+public:
+    const OpMetrics& operator[](ListOp op) const {
+        return ops[static_cast<int>(op)];
     }
     
-    // Delete node by value (deletes first occurrence)
-    void deleteByValue(int value) {
-        // Check if list is empty
-        if (head == nullptr) {
-            throw runtime_error("Cannot delete from an empty list!");
-        }
-        
-        // If the head node contains the value
-        if (head->data == value) {
-            Node* temp = head;
-            head = head->next;
-            cout << "Deleted node with value " << value << "." << endl;
-            delete temp;
-            size--;
-            return;
+    // Largest size the list has reached
+    int sizeHighWater() const {
+        return highWater;
+    }
+    
+    // Charge work to the operation in progress (ignored outside of one)
+    void visit(long long nodes) {
+        if (active != ListOp::Count) {
+            ops[static_cast<int>(active)].nodesVisited += nodes;
         }
-        
-        // Search for the node with the value
-        Node* temp = head;
-        while (temp->next != nullptr && temp->next->data != value) {
-            temp = temp->next;
+    }
+    
+    void allocated() {
+        if (active != ListOp::Count) {
+            ops[static_cast<int>(active)].allocations++;
         }
-        
-        // If value not found
-        if (temp->next == nullptr) {
-            throw runtime_error("Value " + to_string(value) + " not found in the list!");
+    }
+    
+    void freed(long long nodes) {
+        if (active != ListOp::Count) {
+            ops[static_cast<int>(active)].frees += nodes;
         }
-        
-        // Delete the node
-        Node* nodeToDelete = temp->next;
-        temp->next = nodeToDelete->next;
-        cout << "Deleted node with value " << value << "." << endl;
-        delete nodeToDelete;
-        size--;
     }
     
-    // Display all nodes in the list
-    void display() const {
-        if (head == nullptr) {
-            cout << "List is empty." << endl;
-            return;
+    void reset(int currentSize) {
+        for (OpMetrics& op : ops) {
+            op = OpMetrics();
         }
-        
-        cout << "Linked List: ";
-        Node* temp = head;
-        while (temp != nullptr) {
-            cout << temp->data;
-            if (temp->next != nullptr) {
-                cout << " -> ";
+        highWater = currentSize;
+    }
+    
+    // One line per operation that was called at least once
+    void print(ostream& os) const {
+        os << "operation          calls   visited/call  allocs   frees   fails   p50 ns   p99 ns   max ns\n";
+        for (int i = 0; i < static_cast<int>(ListOp::Count); i++) {
+            const OpMetrics& op = ops[i];
+            if (op.calls == 0) {
+                continue;
             }
-            temp = temp->next;
+            ostringstream line;
+            line << left << setw(17) << listOpName(static_cast<ListOp>(i)) << right
+                 << setw(7) << op.calls
+                 << setw(15) << fixed << setprecision(1) << static_cast<double>(op.nodesVisited) / op.calls
+                 << setw(8) << op.allocations << setw(8) << op.frees << setw(8) << op.failures
+                 << setw(9) << op.latency.percentile(0.50) << setw(9) << op.latency.percentile(0.99)
+                 << setw(9) << op.latency.maximum() << '\n';
+            os << line.str();
         }
-        cout << " -> NULL" << endl;
-        cout << "Size: " << size << " nodes" << endl;
+        os << "size high-water mark: " << highWater << '\n';
     }
+};
+
+// Times one public operation and charges everything that happens inside it
+// (including nested public calls) to that operation
+class MetricsScope {
+private:
+    ListMetrics& metrics;
+    const int& size;
+    bool outermost;
+    bool failed = false;
+    int exceptionsBefore;
+    chrono::steady_clock::time_point start;
     
-    // Get the current size of the list
-    int getSize() const {
-        return size;
+public:
+    MetricsScope(ListMetrics& target, ListOp op, const int& listSize)
+        : metrics(target), size(listSize), outermost(target.active == ListOp::Count) {
+        if (outermost) {
+            metrics.active = op;
+            exceptionsBefore = uncaught_exceptions();
+            start = chrono::steady_clock::now();
+        }
     }
     
-    // Clear all nodes from the list
-    void clear() {
-        while (head != nullptr) {
-            Node* temp = head;
-            head = head->next;
-            delete temp;
+    ~MetricsScope() {
+        if (!outermost) {
+            return;
         }
-        size = 0;
+        auto elapsed = chrono::steady_clock::now() - start;
+        OpMetrics& op = metrics.ops[static_cast<int>(metrics.active)];
+        op.calls++;
+        op.latency.record(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(elapsed).count()));
+        if (failed || uncaught_exceptions() > exceptionsBefore) {
+            op.failures++;
+        }
+        metrics.highWater = max(metrics.highWater, size);
+        metrics.active = ListOp::Count;
     }
     
-    // Check if list is empty
-    bool isEmpty() const {
-        return head == nullptr;
+    // Count the call as failed even though it returns normally
+    void fail() {
+        failed = true;
     }
+    
+    MetricsScope(const MetricsScope&) = delete;
+    MetricsScope& operator=(const MetricsScope&) = delete;
 };
+#endif
 
-// Helper function to print section headers
-void printSection(const string& title) {
-    cout << "\n" << string(50, '=') << endl;
-    cout << title << endl;
-    cout << string(50, '=') << endl;
-}
+// ============================================================================
+// BINARY SNAPSHOTS
+// ============================================================================
 
-// Test Case 1: Basic operations
-void testCase1() {
-    printSection("TEST CASE 1: Basic Insert and Delete Operations");
-    
-    LinkedList list;
-    
-    cout << "\n||====> Inserting elements <====||" << endl;
-    list.insertAtEnd(10);
-    list.insertAtEnd(20);
-    list.insertAtEnd(30);
-    list.display();
+// On-disk layout: this header followed by `count` raw values in native byte
+// order. A file from a machine with the other byte order fails the version
+// check instead of loading garbage.
+struct SnapshotHeader {
+    char magic[8];         // "SLLSNAP" and a terminating zero
+    uint32_t version;
+    uint32_t elementSize;  // sizeof the value type that wrote the file
+    uint64_t count;        // Number of values that follow
+    uint64_t checksum;     // SnapshotChecksum of the value bytes
+};
+
+static_assert(sizeof(SnapshotHeader) == 32, "Snapshot header must stay 32 bytes");
+
+constexpr char snapshotMagic[8] = "SLLSNAP";
+constexpr uint32_t snapshotVersion = 1;
+
+// Values are streamed through buffers of this size when writing or reading
+constexpr size_t snapshotChunkBytes = 1 << 16;
+
+// FNV-1a style checksum that mixes eight bytes at a time
+// It can be fed in pieces of any size and gives the same result as a single
+// call over all the bytes, so chunked readers and writers agree.
+class SnapshotChecksum {
+private:
+    uint64_t state;
+    unsigned char pending[8];  // Bytes waiting to complete a word
+    size_t pendingBytes;
     
-    cout << "\n||====> Insert at beginning <====||" << endl;
-    list.insertAtBeginning(5);
-    list.display();
+    void mix(uint64_t word) {
+        state = (state ^ word) * 0x100000001B3ull;
+    }
     
-    cout << "\n||====> Insert at middle (position 2) <====||" << endl;
-    list.insertAtMiddle(15, 2);
-    list.display();
+public:
+    SnapshotChecksum() : state(0xCBF29CE484222325ull), pendingBytes(0) {}
     
-    cout << "\n||====> Delete by position (position 3) <====||" << endl;
-    list.deleteByPosition(3);
-    list.display();
+    void update(const void* data, size_t bytes) {
+        const unsigned char* in = static_cast<const unsigned char*>(data);
+        
+        // Top up a partial word left over from the previous call
+        while (pendingBytes > 0 && pendingBytes < 8 && bytes > 0) {
+            pending[pendingBytes++] = *in++;
+            bytes--;
+        }
+        if (pendingBytes == 8) {
+            uint64_t word;
+            memcpy(&word, pending, 8);
+            mix(word);
+            pendingBytes = 0;
+        }
+        
+        for (; bytes >= 8; in += 8, bytes -= 8) {
+            uint64_t word;
+            memcpy(&word, in, 8);
+            mix(word);
+        }
+        
+        while (bytes > 0) {
+            pending[pendingBytes++] = *in++;
+            bytes--;
+        }
+    }
     
-    cout << "\n||====> Delete by value (value 15) <====||" << endl;
-    list.deleteByValue(15);
-    list.display();
+    uint64_t value() const {
+        uint64_t result = state;
+        for (size_t i = 0; i < pendingBytes; i++) {
+            result = (result ^ pending[i]) * 0x100000001B3ull;
+        }
+        return result;
+    }
+};
+
+// Throw if `header` does not describe a snapshot of values of `elementSize`
+inline void checkSnapshotHeader(const SnapshotHeader& header, size_t elementSize, const string& path) {
+    if (memcmp(header.magic, snapshotMagic, sizeof(snapshotMagic)) != 0) {
+        throw runtime_error("File " + path + " is not a list snapshot!");
+    }
+    if (header.version != snapshotVersion) {
+        throw runtime_error("Snapshot " + path + " has unsupported version " + to_string(header.version) + "!");
+    }
+    if (header.elementSize != elementSize) {
+        throw runtime_error("Snapshot " + path + " holds " + to_string(header.elementSize)
+                            + "-byte values, expected " + to_string(elementSize) + "!");
+    }
 }
 
-// Test Case 2: Edge cases and error handling
-void testCase2() {
-    printSection("TEST CASE 2: Edge Cases and Error Handling");
+// Writes a snapshot one value at a time through a fixed-size chunk buffer,
+// so a sequence of any length (even one never held in memory at once) can
+// be saved. The header is completed with the count and checksum by close();
+// until then the file has no magic, so a half-written file never loads.
+template <typename T>
+class SnapshotWriter {
+    static_assert(is_trivially_copyable_v<T>, "Snapshots store values as raw bytes");
     
-    LinkedList list;
+private:
+    FILE* file;
+    string path;
+    vector<unsigned char> chunk;
+    size_t used;  // Bytes filled in chunk
+    uint64_t count;
+    SnapshotChecksum checksum;
     
-    cout << "\n||====> Attempting to delete from empty list <====||" << endl;
-    try {
-        list.deleteByPosition(0);
-    } catch (const exception& e) {
-        cout << "X Error caught: " << e.what() << endl;
+    void flushChunk() {
+        if (used > 0 && fwrite(chunk.data(), 1, used, file) != used) {
+            throw runtime_error("Failed writing snapshot " + path + "!");
+        }
+        used = 0;
     }
     
-    cout << "\n||====> Insert into empty list <====||" << endl;
-    list.insertAtBeginning(100);
-    list.display();
+public:
+    explicit SnapshotWriter(const string& target)
+        : file(fopen(target.c_str(), "wb")), path(target),
+          chunk(max(snapshotChunkBytes / sizeof(T), size_t(1)) * sizeof(T)), used(0), count(0) {
+        if (file == nullptr) {
+            throw runtime_error("Cannot open snapshot file " + path + " for writing!");
+        }
+        SnapshotHeader placeholder = {};
+        if (fwrite(&placeholder, sizeof(placeholder), 1, file) != 1) {
+            fclose(file);
+            throw runtime_error("Failed writing snapshot " + path + "!");
+        }
+    }
     
-    cout << "\n||====> Attempting invalid position insertion <====||" << endl;
-    try {
-        list.insertAtMiddle(200, 5);
-    } catch (const exception& e) {
-        cout << "X Error caught: " << e.what() << endl;
+    ~SnapshotWriter() {
+        if (file != nullptr) {
+            fclose(file);
+        }
     }
     
-    cout << "\n||====> Valid insertion at position 1 <====||" << endl;
-    list.insertAtMiddle(150, 1);
-    list.display();
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
     
-    cout << "\n||====> Attempting to delete non-existent value <====||" << endl;
-    try {
-        list.deleteByValue(999);
-    } catch (const exception& e) {
-        cout << "X Error caught: " << e.what() << endl;
+    void write(const T& value) {
+        memcpy(chunk.data() + used, &value, sizeof(T));
+        checksum.update(&value, sizeof(T));
+        used += sizeof(T);
+        count++;
+        if (used == chunk.size()) {
+            flushChunk();
+        }
     }
     
-    cout << "\n====> Delete all elements <====" << endl;
-    list.deleteByPosition(0);
-    list.deleteByPosition(0);
+    // Flush the last chunk, fill in the header and close the file
+    void close() {
+        flushChunk();
+        
+        SnapshotHeader header = {};
+        memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+        header.version = snapshotVersion;
+        header.elementSize = sizeof(T);
+        header.count = count;
+        header.checksum = checksum.value();
+        
+        bool ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = (fclose(file) == 0) && ok;
+        file = nullptr;
+        if (!ok) {
+            throw runtime_error("Failed writing snapshot " + path + "!");
+        }
+    }
+};
+
+// Reads a snapshot back in fixed-size chunks with plain buffered I/O, so
+// files larger than memory can be processed. The checksum is verified once
+// the last chunk has been handed out.
+template <typename T>
+class SnapshotReader {
+    static_assert(is_trivially_copyable_v<T>, "Snapshots store values as raw bytes");
+    static_assert(alignof(T) <= alignof(max_align_t), "Snapshot values must not be over-aligned");
+    
+private:
+    FILE* file;
+    string path;
+    SnapshotHeader header;
+    
+public:
+    explicit SnapshotReader(const string& source) : file(fopen(source.c_str(), "rb")), path(source) {
+        if (file == nullptr) {
+            throw runtime_error("Cannot open snapshot file " + path + "!");
+        }
+        if (fread(&header, sizeof(header), 1, file) != 1) {
+            fclose(file);
+            throw runtime_error("File " + path + " is not a list snapshot!");
+        }
+        try {
+            checkSnapshotHeader(header, sizeof(T), path);
+        } catch (...) {
+            fclose(file);
+            throw;
+        }
+    }
+    
+    ~SnapshotReader() {
+        fclose(file);
+    }
+    
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+    
+    uint64_t count() const {
+        return header.count;
+    }
+    
+    // Call visit(values, n) for each chunk in file order, then check the
+    // checksum (throws if the file is truncated or corrupt)
+    template <typename Visitor>
+    void forEachChunk(Visitor visit) {
+        size_t chunkValues = max(snapshotChunkBytes / sizeof(T), size_t(1));
+        unique_ptr<unsigned char[]> buffer(new unsigned char[chunkValues * sizeof(T)]);
+        const T* values = reinterpret_cast<const T*>(buffer.get());
+        SnapshotChecksum checksum;
+        
+        for (uint64_t remaining = header.count; remaining > 0;) {
+            size_t n = static_cast<size_t>(min<uint64_t>(remaining, chunkValues));
+            if (fread(buffer.get(), sizeof(T), n, file) != n) {
+                throw runtime_error("Snapshot " + path + " is truncated!");
+            }
+            checksum.update(buffer.get(), n * sizeof(T));
+            visit(values, n);
+            remaining -= n;
+        }
+        
+        if (checksum.value() != header.checksum) {
+            throw runtime_error("Snapshot " + path + " failed its checksum!");
+        }
+    }
+};
+
+#if SNAPSHOT_USE_MMAP
+// Maps a whole snapshot into memory read-only, so loading reads straight
+// from the page cache with no copy into an intermediate buffer. Offers the
+// same forEachChunk interface as SnapshotReader.
+template <typename T>
+class MappedSnapshot {
+    static_assert(is_trivially_copyable_v<T>, "Snapshots store values as raw bytes");
+    static_assert(alignof(T) <= sizeof(SnapshotHeader), "Snapshot values must not be over-aligned");
+    
+private:
+    void* mapping;
+    size_t length;
+    string path;
+    SnapshotHeader header;
+    
+public:
+    explicit MappedSnapshot(const string& source) : mapping(MAP_FAILED), length(0), path(source) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open snapshot file " + path + "!");
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SnapshotHeader)) {
+            ::close(fd);
+            throw runtime_error("File " + path + " is not a list snapshot!");
+        }
+        length = static_cast<size_t>(info.st_size);
+        mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping stays valid without the descriptor
+        if (mapping == MAP_FAILED) {
+            throw runtime_error("Cannot map snapshot file " + path + "!");
+        }
+        
+        memcpy(&header, mapping, sizeof(header));
+        try {
+            checkSnapshotHeader(header, sizeof(T), path);
+            if ((length - sizeof(header)) / sizeof(T) < header.count) {
+                throw runtime_error("Snapshot " + path + " is truncated!");
+            }
+        } catch (...) {
+            munmap(mapping, length);
+            throw;
+        }
+        
+        // Loading reads front to back, so ask for aggressive read-ahead
+        madvise(mapping, length, MADV_SEQUENTIAL);
+    }
+    
+    ~MappedSnapshot() {
+        munmap(mapping, length);
+    }
+    
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+    
+    uint64_t count() const {
+        return header.count;
+    }
+    
+    // Call visit(values, n) for each chunk in file order, then check the
+    // checksum (throws if the file is corrupt)
+    template <typename Visitor>
+    void forEachChunk(Visitor visit) {
+        size_t chunkValues = max(snapshotChunkBytes / sizeof(T), size_t(1));
+        const T* values = reinterpret_cast<const T*>(static_cast<const unsigned char*>(mapping) + sizeof(header));
+        SnapshotChecksum checksum;
+        
+        for (uint64_t remaining = header.count; remaining > 0;) {
+            size_t n = static_cast<size_t>(min<uint64_t>(remaining, chunkValues));
+            checksum.update(values, n * sizeof(T));
+            visit(values, n);
+            values += n;
+            remaining -= n;
+        }
+        
+        if (checksum.value() != header.checksum) {
+            throw runtime_error("Snapshot " + path + " failed its checksum!");
+        }
+    }
+};
+#endif
+
+// ============================================================================
+// SINGLY LINKED LIST
+// ============================================================================
+
+// Hint that a node is about to be read, so the cache miss for it overlaps
+// with work on the current node (a no-op where the builtin is missing)
+inline void prefetchNode(const void* node) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(node);
+#else
+    (void)node;
+#endif
+}
+
+// Node structure representing each element in the linked list
+template <typename T>
+struct Node {
+    T data;
+    Node* next;
+    
+    // Constructor builds the value in place from any constructor arguments
+    template <typename... Args>
+    explicit Node(Args&&... args) : data(std::forward<Args>(args)...), next(nullptr) {}
+};
+
+// Usage statistics reported by a node allocator
+struct AllocatorStats {
+    int slabCount = 0;          // Number of slabs currently held
+    int slabCapacity = 0;       // Total node slots across all slabs
+    int liveNodes = 0;          // Nodes currently handed out
+    long long allocations = 0;  // Total number of nodes created
+    long long reused = 0;       // Creations served from the free list
+    
+    // Fraction of creations that recycled a previously freed node
+    double reuseRate() const {
+        return allocations == 0 ? 0.0 : static_cast<double>(reused) / allocations;
+    }
+};
+
+// Node allocator that makes one allocator call per node (the original
+// behaviour). Memory comes from Alloc, rebound to the node type.
+template <typename NodeType, typename Alloc>
+class HeapNodeAllocator {
+private:
+    using NodeAlloc = typename allocator_traits<Alloc>::template rebind_alloc<NodeType>;
+    using Traits = allocator_traits<NodeAlloc>;
+    
+    NodeAlloc alloc;
+    AllocatorStats counters;
+    
+public:
+    // Nodes must be freed one at a time
+    static constexpr bool releasesInBulk = false;
+    
+    explicit HeapNodeAllocator(const Alloc& base = Alloc()) : alloc(base) {}
+    
+    template <typename... Args>
+    NodeType* create(Args&&... args) {
+        NodeType* node = Traits::allocate(alloc, 1);
+        try {
+            Traits::construct(alloc, node, std::forward<Args>(args)...);
+        } catch (...) {
+            Traits::deallocate(alloc, node, 1);
+            throw;
+        }
+        counters.liveNodes++;
+        counters.allocations++;
+        return node;
+    }
+    
+    void destroy(NodeType* node) {
+        Traits::destroy(alloc, node);
+        Traits::deallocate(alloc, node, 1);
+        counters.liveNodes--;
+    }
+    
+    // Nodes come from the heap one by one, so adjacency is up to Alloc
+    template <typename... Args>
+    NodeType* createContiguous(Args&&... args) {
+        return create(std::forward<Args>(args)...);
+    }
+    
+    void releaseAll() {}
+    
+    // Nodes are allocated one by one, so there is nothing to set aside
+    void reserve(int) {}
+    
+    // Copy of the allocator nodes come from (to build a sibling allocator)
+    Alloc allocator() const {
+        return Alloc(alloc);
+    }
+    
+    // Take responsibility for every node `other` handed out, so they can be
+    // relinked into this allocator's list. Fails (returns false) when the
+    // two underlying allocators cannot free each other's memory.
+    bool adopt(HeapNodeAllocator& other) {
+        if (!(alloc == other.alloc)) {
+            return false;
+        }
+        counters.liveNodes += other.counters.liveNodes;
+        other.counters.liveNodes = 0;
+        return true;
+    }
+    
+    // Take responsibility for `count` of the nodes `other` handed out
+    bool share(HeapNodeAllocator& other, int count) {
+        if (!(alloc == other.alloc)) {
+            return false;
+        }
+        counters.liveNodes += count;
+        other.counters.liveNodes -= count;
+        return true;
+    }
+    
+    void swap(HeapNodeAllocator& other) noexcept {
+        using std::swap;
+        swap(alloc, other.alloc);
+        swap(counters, other.counters);
+    }
+    
+    AllocatorStats stats() const {
+        return counters;
+    }
+};
+
+// Node allocator that carves nodes out of large slabs obtained from Alloc
+// Freed nodes go onto an intrusive free list (the link is stored inside the
+// dead node itself) and are handed out again before a new slab is touched.
+// Releasing everything frees whole slabs, so teardown costs O(slabs).
+template <typename NodeType, typename Alloc>
+class SlabNodeAllocator {
+private:
+    // A free slot reuses the node's storage to hold the free-list link
+    union Slot {
+        Slot* nextFree;
+        alignas(NodeType) unsigned char storage[sizeof(NodeType)];
+    };
+    
+    using SlotAlloc = typename allocator_traits<Alloc>::template rebind_alloc<Slot>;
+    using Traits = allocator_traits<SlotAlloc>;
+    
+    struct Slab {
+        Slot* slots;
+        int capacity;
+    };
+    
+    // Slabs are grouped in pools. A pool normally has a single owner, but
+    // once part of a chain moves to another list both allocators hold the
+    // pools involved (see share), and a pool is only freed when the last
+    // allocator holding it lets go.
+    struct Pool {
+        SlotAlloc alloc;
+        vector<Slab> slabs;
+        
+        explicit Pool(const SlotAlloc& base) : alloc(base) {}
+        
+        ~Pool() {
+            for (const Slab& slab : slabs) {
+                Traits::deallocate(alloc, slab.slots, slab.capacity);
+            }
+        }
+        
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+    };
+    
+    static constexpr int firstSlabNodes = 64;     // Small lists stay small
+    static constexpr int maxSlabNodes = 16384;    // Growth stops doubling here
+    
+    SlotAlloc alloc;
+    vector<shared_ptr<Pool>> pools;  // New slabs go into pools.back()
+    Slab current;         // Newest slab this allocator bump-allocates from
+    int usedInLastSlab;   // Bump index into `current`
+    Slot* freeList;       // Most recently freed slot
+    Slot* freeTail;       // Oldest freed slot, so free lists join in O(1)
+    AllocatorStats counters;
+    
+    // Allocate a new slab, doubling the size of the previous one (or of
+    // exactly `capacity` slots when one is given)
+    void addSlab(int capacity = 0) {
+        if (capacity == 0) {
+            capacity = current.slots == nullptr ? firstSlabNodes : current.capacity * 2;
+            if (capacity > maxSlabNodes) {
+                capacity = maxSlabNodes;
+            }
+        }
+        
+        if (pools.empty()) {
+            pools.push_back(make_shared<Pool>(alloc));
+        }
+        Slot* slots = Traits::allocate(alloc, capacity);
+        pools.back()->slabs.push_back({slots, capacity});
+        current = {slots, capacity};
+        usedInLastSlab = 0;
+        counters.slabCount++;
+        counters.slabCapacity += capacity;
+    }
+    
+    // Build a node in `slot`
+    template <typename... Args>
+    NodeType* construct(Slot* slot, Args&&... args) {
+        NodeType* node;
+        try {
+            node = ::new (static_cast<void*>(slot->storage)) NodeType(std::forward<Args>(args)...);
+        } catch (...) {
+            // Constructor threw - keep the slot for the next creation
+            pushFree(slot);
+            throw;
+        }
+        counters.liveNodes++;
+        counters.allocations++;
+        return node;
+    }
+    
+    void pushFree(Slot* slot) {
+        if (freeList == nullptr) {
+            freeTail = slot;
+        }
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+    
+    // Add every pool of `other` that this allocator does not hold yet
+    void mergePools(const SlabNodeAllocator& other) {
+        for (const shared_ptr<Pool>& pool : other.pools) {
+            if (find(pools.begin(), pools.end(), pool) == pools.end()) {
+                pools.insert(pools.begin(), pool);  // Keep our own pool last
+                counters.slabCount += static_cast<int>(pool->slabs.size());
+                for (const Slab& slab : pool->slabs) {
+                    counters.slabCapacity += slab.capacity;
+                }
+            }
+        }
+    }
+    
+public:
+    // Whole slabs can be dropped at once (after any node destructors ran)
+    static constexpr bool releasesInBulk = true;
+    
+    explicit SlabNodeAllocator(const Alloc& base = Alloc())
+        : alloc(base), current{nullptr, 0}, usedInLastSlab(0), freeList(nullptr), freeTail(nullptr) {}
+    
+    ~SlabNodeAllocator() {
+        releaseAll();
+    }
+    
+    // Slabs are owned exclusively - copying would double-free them
+    SlabNodeAllocator(const SlabNodeAllocator&) = delete;
+    SlabNodeAllocator& operator=(const SlabNodeAllocator&) = delete;
+    
+    template <typename... Args>
+    NodeType* create(Args&&... args) {
+        Slot* slot;
+        
+        if (freeList != nullptr) {
+            // Reuse the most recently freed node (likely still in cache)
+            slot = freeList;
+            freeList = freeList->nextFree;
+            if (freeList == nullptr) {
+                freeTail = nullptr;
+            }
+            counters.reused++;
+        } else {
+            if (usedInLastSlab == current.capacity) {
+                addSlab();
+            }
+            slot = &current.slots[usedInLastSlab++];
+        }
+        return construct(slot, std::forward<Args>(args)...);
+    }
+    
+    // Create a node in the next never-used slot, skipping the free list, so
+    // successive calls return adjacent nodes (used by compaction)
+    template <typename... Args>
+    NodeType* createContiguous(Args&&... args) {
+        if (usedInLastSlab == current.capacity) {
+            addSlab();
+        }
+        return construct(&current.slots[usedInLastSlab++], std::forward<Args>(args)...);
+    }
+    
+    // Set aside room so the next `count` creations come from one slab
+    // (used before bulk loads to avoid a run of doubling slabs)
+    void reserve(int count) {
+        if (count > current.capacity - usedInLastSlab) {
+            addSlab(count);
+        }
+    }
+    
+    void destroy(NodeType* node) {
+        node->~NodeType();
+        pushFree(reinterpret_cast<Slot*>(node));
+        counters.liveNodes--;
+    }
+    
+    // Let go of every slab at once; nodes still handed out must not need
+    // their destructors run (the list destroys non-trivial values first).
+    // Pools shared with another allocator stay alive until it lets go too.
+    void releaseAll() {
+        pools.clear();
+        current = {nullptr, 0};
+        usedInLastSlab = 0;
+        freeList = nullptr;
+        freeTail = nullptr;
+        
+        // Lifetime totals are kept so the reuse rate stays meaningful
+        counters.slabCount = 0;
+        counters.slabCapacity = 0;
+        counters.liveNodes = 0;
+    }
+    
+    // Copy of the allocator slabs come from (to build a sibling allocator)
+    Alloc allocator() const {
+        return Alloc(alloc);
+    }
+    
+    // Take over every slab of `other`, and the nodes living in them, so they
+    // can be relinked into this allocator's list. Fails (returns false) when
+    // the two underlying allocators cannot free each other's memory.
+    bool adopt(SlabNodeAllocator& other) {
+        if (!(alloc == other.alloc)) {
+            return false;
+        }
+        if (other.pools.empty()) {
+            return true;
+        }
+        
+        mergePools(other);
+        if (current.slots == nullptr) {
+            // Carry on bump-allocating in the other's newest slab
+            current = other.current;
+            usedInLastSlab = other.usedInLastSlab;
+        }
+        
+        // Chain the other's free slots in front of ours
+        if (other.freeList != nullptr) {
+            other.freeTail->nextFree = freeList;
+            if (freeList == nullptr) {
+                freeTail = other.freeTail;
+            }
+            freeList = other.freeList;
+        }
+        counters.liveNodes += other.counters.liveNodes;
+        
+        other.releaseAll();
+        return true;
+    }
+    
+    // Take responsibility for `count` of the nodes `other` handed out (but
+    // not its other nodes or free slots), so part of a chain can move to
+    // this allocator's list. Both allocators then hold each other's pools:
+    // memory is shared rather than split, and is returned once neither list
+    // needs it. Fails (returns false) like adopt.
+    bool share(SlabNodeAllocator& other, int count) {
+        if (!(alloc == other.alloc)) {
+            return false;
+        }
+        if (&other != this) {
+            mergePools(other);
+            other.mergePools(*this);
+            counters.liveNodes += count;
+            other.counters.liveNodes -= count;
+        }
+        return true;
+    }
+    
+    void swap(SlabNodeAllocator& other) noexcept {
+        using std::swap;
+        swap(alloc, other.alloc);
+        swap(pools, other.pools);
+        swap(current, other.current);
+        swap(usedInLastSlab, other.usedInLastSlab);
+        swap(freeList, other.freeList);
+        swap(freeTail, other.freeTail);
+        swap(counters, other.counters);
+    }
+    
+    AllocatorStats stats() const {
+        return counters;
+    }
+};
+
+// Open-addressing hash map from a node address to side data that only
+// some nodes carry. Same scheme as ValueIndex: a Fibonacci multiply,
+// linear probing and backward-shift deletion, grown at 70% load.
+template <typename Value>
+class AddressMap {
+private:
+    struct Slot {
+        const void* key;  // Node address (null = empty slot)
+        Value value;
+    };
+    
+    static constexpr size_t minCapacity = 16;
+    
+    vector<Slot> slots;  // Capacity is always a power of two
+    int shift;           // 64 - log2(capacity)
+    int used;
+    
+    size_t home(const void* key) const {
+        uint64_t h = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(key));
+        return static_cast<size_t>((h * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+    
+    void rehash(size_t capacity) {
+        vector<Slot> old(capacity, Slot{nullptr, Value{}});
+        old.swap(slots);
+        
+        shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) {
+            shift--;
+        }
+        
+        size_t mask = slots.size() - 1;
+        for (const Slot& slot : old) {
+            if (slot.key != nullptr) {
+                size_t i = home(slot.key);
+                while (slots[i].key != nullptr) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = slot;
+            }
+        }
+    }
+    
+public:
+    AddressMap() : shift(64), used(0) {}
+    
+    // Look up the value stored for `key`, or null if there is none
+    Value* find(const void* key) {
+        if (used == 0) {
+            return nullptr;
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t i = home(key); slots[i].key != nullptr; i = (i + 1) & mask) {
+            if (slots[i].key == key) {
+                return &slots[i].value;
+            }
+        }
+        return nullptr;
+    }
+    
+    // Store a value for a key not yet in the map
+    // Pointers returned earlier by find() are invalidated
+    void insert(const void* key, const Value& value) {
+        if (slots.empty() || (used + 1) * 10 > static_cast<int>(slots.size()) * 7) {
+            rehash(slots.empty() ? minCapacity : slots.size() * 2);
+        }
+        
+        size_t mask = slots.size() - 1;
+        size_t i = home(key);
+        while (slots[i].key != nullptr) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = Slot{key, value};
+        used++;
+    }
+    
+    // Remove the value stored for `key`, if any
+    // Pointers returned earlier by find() are invalidated
+    void erase(const void* key) {
+        if (used == 0) {
+            return;
+        }
+        size_t mask = slots.size() - 1;
+        size_t hole = home(key);
+        while (slots[hole].key != key) {
+            if (slots[hole].key == nullptr) {
+                return;
+            }
+            hole = (hole + 1) & mask;
+        }
+        
+        // Pull later slots of the same probe run back into the hole
+        for (size_t i = (hole + 1) & mask; slots[i].key != nullptr; i = (i + 1) & mask) {
+            size_t want = home(slots[i].key);
+            bool canMove = (i > hole) ? (want <= hole || want > i)
+                                      : (want <= hole && want > i);
+            if (canMove) {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole] = Slot{nullptr, Value{}};
+        used--;
+    }
+    
+    // Forget every key but keep the table allocated
+    void clear() {
+        if (used > 0) {
+            fill(slots.begin(), slots.end(), Slot{nullptr, Value{}});
+            used = 0;
+        }
+    }
+    
+    // Release the table entirely
+    void release() {
+        vector<Slot>().swap(slots);
+        shift = 64;
+        used = 0;
+    }
+    
+    size_t memoryBytes() const {
+        return slots.capacity() * sizeof(Slot);
+    }
+    
+    void swap(AddressMap& other) noexcept {
+        using std::swap;
+        swap(slots, other.slots);
+        swap(shift, other.shift);
+        swap(used, other.used);
+    }
+};
+
+// Indexable skip list laid over an existing node chain
+// The chain itself is level 0. Each higher level is an "express lane" of
+// entries that point at chain nodes and record how many chain steps
+// (the width) it takes to reach the next entry on the same lane. Summing
+// widths while moving right and down finds any position in O(log n).
+// Climbing back up from a node's level 1 entry, found through an address
+// map, gives the position of a node in O(log n) as well.
+template <typename NodeType>
+class SkipListIndex {
+private:
+    struct Lane {
+        NodeType* node;  // Chain node this entry stands for (null for a lane head)
+        Lane* right;     // Next entry on the same level
+        Lane* down;      // Same node one level lower (null on level 1)
+        Lane* up;        // Same node one level higher (null at the top of a tower)
+        int width;       // Chain steps to `right`, or to the end of the list
+    };
+    
+    static constexpr int maxLevels = 24;
+    
+    vector<Lane*> heads;  // heads[l] starts level l + 1, at position -1
+    vector<Lane*> tails;  // tails[l] is the last entry on level l + 1
+    AddressMap<Lane*> towers;  // Chain node -> its level 1 entry, if it has one
+    int count;            // Number of chain nodes covered by the index
+    unsigned rngState;    // xorshift state for tower heights
+    
+    // Entries found by locate(), one per level, and their positions
+    Lane* update[maxLevels];
+    int updatePos[maxLevels];
+    
+    LIST_METRICS_ONLY(long long visited = 0;)  // Lane and chain steps taken
+    
+    // Random tower height: each extra level with probability 1/4
+    int randomHeight() {
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 17;
+        rngState ^= rngState << 5;
+        
+        int height = 0;
+        unsigned bits = rngState;
+        while ((bits & 3) == 0 && height < maxLevels) {
+            height++;
+            bits >>= 2;
+        }
+        return height;
+    }
+    
+    // Add an empty level on top covering the whole list
+    void addLevel() {
+        Lane* lower = heads.empty() ? nullptr : heads.back();
+        heads.push_back(new Lane{nullptr, nullptr, lower, nullptr, count + 1});
+        tails.push_back(heads.back());
+    }
+    
+    // On every level, find the last entry whose position is below `position`
+    void locate(int position) {
+        int levels = static_cast<int>(heads.size());
+        
+        // At the front every level's answer is its head
+        if (position == 0) {
+            for (int level = 0; level < levels; level++) {
+                update[level] = heads[level];
+                updatePos[level] = -1;
+            }
+            return;
+        }
+
+        // Past the last level 1 entry, the tail of every level is the answer
+        // (a tail spans to the end of the list, so its position is
+        // count - width); this keeps appends and tail work O(levels)
+        if (levels > 0 && count - tails[0]->width < position) {
+            for (int level = 0; level < levels; level++) {
+                update[level] = tails[level];
+                updatePos[level] = count - tails[level]->width;
+            }
+            return;
+        }
+        
+        Lane* current = levels > 0 ? heads[levels - 1] : nullptr;
+        int pos = -1;
+        
+        for (int level = levels - 1; level >= 0; level--) {
+            while (current->right != nullptr && pos + current->width < position) {
+                pos += current->width;
+                current = current->right;
+                LIST_METRICS_ONLY(visited++;)
+            }
+            update[level] = current;
+            updatePos[level] = pos;
+            current = current->down;
+        }
+    }
+    
+public:
+    SkipListIndex() : count(0), rngState(0x9E3779B9u) {}
+    
+    ~SkipListIndex() {
+        reset();
+    }
+    
+    SkipListIndex(const SkipListIndex&) = delete;
+    SkipListIndex& operator=(const SkipListIndex&) = delete;
+    
+    // True once build() has been called (until the next reset)
+    bool active() const {
+        return !heads.empty();
+    }
+    
+    // Drop every lane; the chain itself is untouched
+    void reset() {
+        for (Lane* level : heads) {
+            while (level != nullptr) {
+                Lane* temp = level;
+                level = level->right;
+                delete temp;
+            }
+        }
+        heads.clear();
+        tails.clear();
+        towers.clear();
+        count = 0;
+    }
+    
+    // Index an existing chain of `size` nodes in one pass
+    void build(NodeType* head, int size) {
+        reset();
+        count = size;
+        addLevel();  // Always keep level 1 so active() means "built"
+        
+        Lane* last[maxLevels];
+        int lastPos[maxLevels];
+        last[0] = heads[0];
+        lastPos[0] = -1;
+        
+        int pos = 0;
+        for (NodeType* node = head; node != nullptr; node = node->next, pos++) {
+            int height = randomHeight();
+            Lane* lower = nullptr;
+            
+            for (int level = 0; level < height; level++) {
+                if (level == static_cast<int>(heads.size())) {
+                    addLevel();
+                    last[level] = heads[level];
+                    lastPos[level] = -1;
+                }
+                Lane* entry = new Lane{node, nullptr, lower, nullptr, 0};
+                last[level]->right = entry;
+                last[level]->width = pos - lastPos[level];
+                last[level] = entry;
+                lastPos[level] = pos;
+                if (lower == nullptr) {
+                    towers.insert(node, entry);
+                } else {
+                    lower->up = entry;
+                }
+                lower = entry;
+            }
+        }
+        
+        // The last entry on each level spans to the end of the list
+        for (int level = 0; level < static_cast<int>(heads.size()); level++) {
+            last[level]->width = size - lastPos[level];
+            tails[level] = last[level];
+        }
+    }
+    
+    // Extend the index over `added` nodes, starting at `first`, that were
+    // linked in after the last node it covers (O(added), like build)
+    void append(NodeType* first, int added) {
+        int levels = static_cast<int>(heads.size());
+        int lastPos[maxLevels];
+        for (int level = 0; level < levels; level++) {
+            lastPos[level] = count - tails[level]->width;
+        }
+        
+        int pos = count;
+        for (NodeType* node = first; pos < count + added; node = node->next, pos++) {
+            int height = randomHeight();
+            Lane* lower = nullptr;
+            
+            for (int level = 0; level < height; level++) {
+                if (level == static_cast<int>(heads.size())) {
+                    addLevel();
+                    lastPos[level] = -1;
+                }
+                Lane* entry = new Lane{node, nullptr, lower, nullptr, 0};
+                tails[level]->right = entry;
+                tails[level]->width = pos - lastPos[level];
+                tails[level] = entry;
+                lastPos[level] = pos;
+                if (lower == nullptr) {
+                    towers.insert(node, entry);
+                } else {
+                    lower->up = entry;
+                }
+                lower = entry;
+            }
+        }
+        
+        count += added;
+        for (int level = 0; level < static_cast<int>(heads.size()); level++) {
+            tails[level]->width = count - lastPos[level];
+        }
+    }
+    
+    // Return the chain node at `position` - 1 (null when position is 0)
+    NodeType* nodeBefore(int position, NodeType* head) {
+        if (position == 0) {
+            return nullptr;
+        }
+        
+        locate(position);
+        
+        // Finish with a short walk along the chain from the level 1 entry
+        NodeType* node = update[0]->node;
+        int pos = updatePos[0];
+        if (node == nullptr) {
+            node = head;
+            pos = 0;
+        }
+        while (pos < position - 1) {
+            node = node->next;
+            pos++;
+            LIST_METRICS_ONLY(visited++;)
+        }
+        return node;
+    }
+    
+    // For a chain sorted by `comp`, find the last node that does not order
+    // after `value` and its position (null and -1 when every node does).
+    // The lanes are searched by value instead of by width.
+    template <typename Value, typename Compare>
+    NodeType* lastNotAfter(const Value& value, Compare& comp, NodeType* head, int& position) {
+        Lane* current = heads.back();
+        int pos = -1;
+        
+        for (int level = static_cast<int>(heads.size()) - 1; level >= 0; level--) {
+            while (current->right != nullptr && !comp(value, current->right->node->data)) {
+                pos += current->width;
+                current = current->right;
+                LIST_METRICS_ONLY(visited++;)
+            }
+            if (level > 0) {
+                current = current->down;
+            }
+        }
+        
+        // Finish with a short walk along the chain from the level 1 entry
+        NodeType* node = current->node;
+        if (node == nullptr) {
+            if (head == nullptr || comp(value, head->data)) {
+                position = -1;
+                return nullptr;
+            }
+            node = head;
+            pos = 0;
+        }
+        while (node->next != nullptr && !comp(value, node->next->data)) {
+            node = node->next;
+            pos++;
+            LIST_METRICS_ONLY(visited++;)
+        }
+        position = pos;
+        return node;
+    }
+    
+    // Point the entries for the chain node at `position` to `node` instead
+    // (after that node's value was moved to new storage)
+    void replaceNode(int position, NodeType* node) {
+        locate(position);
+        for (int level = 0; level < static_cast<int>(heads.size()); level++) {
+            Lane* before = update[level];
+            if (before->right != nullptr && updatePos[level] + before->width == position) {
+                if (level == 0) {
+                    towers.erase(before->right->node);
+                    towers.insert(node, before->right);
+                }
+                before->right->node = node;
+            }
+        }
+    }
+    
+    // Record that `node` was linked into the chain at `position`
+    void onInsert(int position, NodeType* node) {
+        int height = randomHeight();
+        while (static_cast<int>(heads.size()) < height) {
+            addLevel();
+        }
+        
+        locate(position);
+        
+        Lane* lower = nullptr;
+        for (int level = 0; level < static_cast<int>(heads.size()); level++) {
+            Lane* before = update[level];
+            if (level < height) {
+                // Split the span of `before` around the new entry
+                int end = updatePos[level] + before->width + 1;
+                Lane* entry = new Lane{node, before->right, lower, nullptr, end - position};
+                before->right = entry;
+                before->width = position - updatePos[level];
+                if (entry->right == nullptr) {
+                    tails[level] = entry;
+                }
+                if (lower == nullptr) {
+                    towers.insert(node, entry);
+                } else {
+                    lower->up = entry;
+                }
+                lower = entry;
+            } else {
+                // The new node sits inside this span and stretches it
+                before->width++;
+            }
+        }
+        count++;
+    }
+    
+    // Record that the chain node at `position` was unlinked
+    void onErase(int position) {
+        locate(position);
+        
+        for (int level = 0; level < static_cast<int>(heads.size()); level++) {
+            Lane* before = update[level];
+            Lane* victim = before->right;
+            if (victim != nullptr && updatePos[level] + before->width == position) {
+                // The erased node had an entry here - absorb its span
+                before->width += victim->width - 1;
+                before->right = victim->right;
+                if (victim == tails[level]) {
+                    tails[level] = before;
+                }
+                if (level == 0) {
+                    towers.erase(victim->node);
+                }
+                delete victim;
+            } else {
+                before->width--;
+            }
+        }
+        count--;
+    }
+    
+    // Return the position of chain node `node`: walk the chain to the next
+    // node with a tower, then climb it, moving right until a taller tower
+    // (or a tail, whose position is count - width) is found
+    int positionOf(NodeType* node) {
+        int steps = 0;
+        for (; node != nullptr; node = node->next, steps++) {
+            Lane** found = towers.find(node);
+            if (found == nullptr) {
+                LIST_METRICS_ONLY(visited++;)
+                continue;
+            }
+            
+            Lane* lane = *found;
+            int ahead = steps;  // Chain steps from `node` back to the start
+            while (lane->right != nullptr) {
+                if (lane->up != nullptr) {
+                    lane = lane->up;
+                } else {
+                    ahead += lane->width;
+                    lane = lane->right;
+                }
+                LIST_METRICS_ONLY(visited++;)
+            }
+            return count - lane->width - ahead;
+        }
+        return count - steps;
+    }
+    
+    // Number of lane entries, for sizing the memory overhead
+    long long laneEntries() const {
+        long long entries = 0;
+        for (Lane* level : heads) {
+            for (Lane* lane = level; lane != nullptr; lane = lane->right) {
+                entries++;
+            }
+        }
+        return entries;
+    }
+    
+    int levels() const {
+        return static_cast<int>(heads.size());
+    }
+    
+#if LIST_METRICS
+    // Steps taken since the last call
+    long long takeVisited() {
+        long long steps = visited;
+        visited = 0;
+        return steps;
+    }
+#endif
+    
+    void swap(SkipListIndex& other) noexcept {
+        using std::swap;
+        swap(heads, other.heads);
+        swap(tails, other.tails);
+        towers.swap(other.towers);
+        swap(count, other.count);
+        swap(rngState, other.rngState);
+    }
+};
+
+// Open-addressing hash index from a value to its first node in a chain
+// Each entry remembers the first node holding the value, that node's
+// predecessor (so it can be unlinked without a search) and how many nodes
+// hold the value. The key is read through the first node, so values are
+// never copied into the table. Linear probing with backward-shift deletion
+// keeps probe sequences short without tombstones.
+// Every node of a value held more than once also gets an occurrence record
+// (its predecessor and its neighbours among the nodes holding the same
+// value), so when the first of them is unlinked the next one takes over
+// in O(1).
+template <typename Key, typename NodeType>
+class ValueIndex {
+public:
+    struct Entry {
+        NodeType* first;   // First node holding the value (null = empty slot)
+        NodeType* before;  // Node linking to `first` (null when it is the head)
+        NodeType* last;    // Last node holding the value
+        int count;         // Number of nodes holding the value
+    };
+    
+    struct Occurrence {
+        NodeType* before;    // Node linking to this one (null for the head)
+        NodeType* prevSame;  // Previous node holding the same value
+        NodeType* nextSame;  // Next node holding the same value
+    };
+    
+private:
+    static constexpr size_t minCapacity = 16;
+    
+    vector<Entry> slots;  // Capacity is always a power of two
+    int shift;            // 64 - log2(capacity), for the multiplicative hash
+    int used;             // Number of distinct values stored
+    AddressMap<Occurrence> occurrences;  // Only for values held more than once
+    
+    // Spread the standard hash over the table with a Fibonacci multiply
+    size_t home(const Key& key) const {
+        uint64_t h = static_cast<uint64_t>(hash<Key>{}(key));
+        return static_cast<size_t>((h * 0x9E3779B97F4A7C15ull) >> shift);
+    }
+    
+    void rehash(size_t capacity) {
+        vector<Entry> old(capacity, Entry{nullptr, nullptr, nullptr, 0});
+        old.swap(slots);
+        
+        shift = 64;
+        for (size_t c = capacity; c > 1; c >>= 1) {
+            shift--;
+        }
+        
+        size_t mask = slots.size() - 1;
+        for (const Entry& entry : old) {
+            if (entry.first != nullptr) {
+                size_t i = home(entry.first->data);
+                while (slots[i].first != nullptr) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = entry;
+            }
+        }
+    }
+    
+public:
+    ValueIndex() : shift(64), used(0) {}
+    
+    // Look up the entry for `key`, or null if no node holds it
+    Entry* find(const Key& key) {
+        if (used == 0) {
+            return nullptr;
+        }
+        size_t mask = slots.size() - 1;
+        for (size_t i = home(key); slots[i].first != nullptr; i = (i + 1) & mask) {
+            if (slots[i].first->data == key) {
+                return &slots[i];
+            }
+        }
+        return nullptr;
+    }
+    
+    // Add an entry for a value not yet in the table
+    // Pointers returned earlier by find() are invalidated
+    Entry* insert(NodeType* first, NodeType* before) {
+        // Grow at 70% load
+        if (slots.empty() || (used + 1) * 10 > static_cast<int>(slots.size()) * 7) {
+            rehash(slots.empty() ? minCapacity : slots.size() * 2);
+        }
+        
+        size_t mask = slots.size() - 1;
+        size_t i = home(first->data);
+        while (slots[i].first != nullptr) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = Entry{first, before, first, 1};
+        used++;
+        return &slots[i];
+    }
+    
+    // Remove an entry found by find()
+    // Pointers returned earlier by find() are invalidated
+    void erase(Entry* entry) {
+        size_t mask = slots.size() - 1;
+        size_t hole = static_cast<size_t>(entry - slots.data());
+        
+        // Pull later entries of the same probe run back into the hole
+        for (size_t i = (hole + 1) & mask; slots[i].first != nullptr; i = (i + 1) & mask) {
+            size_t want = home(slots[i].first->data);
+            bool canMove = (i > hole) ? (want <= hole || want > i)
+                                      : (want <= hole && want > i);
+            if (canMove) {
+                slots[hole] = slots[i];
+                hole = i;
+            }
+        }
+        slots[hole] = Entry{nullptr, nullptr, nullptr, 0};
+        used--;
+    }
+    
+    // Forget every entry but keep the table allocated
+    void clear() {
+        fill(slots.begin(), slots.end(), Entry{nullptr, nullptr, nullptr, 0});
+        used = 0;
+        occurrences.clear();
+    }
+    
+    // Release the table entirely
+    void release() {
+        vector<Entry>().swap(slots);
+        shift = 64;
+        used = 0;
+        occurrences.release();
+    }
+    
+    // Occurrence record of `node` (null unless its value is held more
+    // than once); pointers are invalidated by addOccurrence/dropOccurrence
+    Occurrence* occurrence(const NodeType* node) {
+        return occurrences.find(node);
+    }
+    
+    void addOccurrence(const NodeType* node, const Occurrence& record) {
+        occurrences.insert(node, record);
+    }
+    
+    void dropOccurrence(const NodeType* node) {
+        occurrences.erase(node);
+    }
+    
+    int distinctValues() const {
+        return used;
+    }
+    
+    size_t memoryBytes() const {
+        return slots.capacity() * sizeof(Entry) + occurrences.memoryBytes();
+    }
+    
+    void swap(ValueIndex& other) noexcept {
+        using std::swap;
+        swap(slots, other.slots);
+        swap(shift, other.shift);
+        swap(used, other.used);
+        occurrences.swap(other.occurrences);
+    }
+};
+
+// Detects whether values can go into the hash-based value index
+template <typename T, typename = void>
+struct IsHashable : false_type {};
+
+template <typename T>
+struct IsHashable<T, void_t<decltype(hash<T>{}(declval<const T&>())),
+                            decltype(declval<const T&>() == declval<const T&>())>> : true_type {};
+
+// Outcome of the non-throwing try* operations. Routine misses are
+// reported here instead of by throwing, so a miss costs a compare rather
+// than an allocation, a formatted message and a stack unwind.
+enum class [[nodiscard]] ListStatus {
+    Ok,
+    Empty,       // The list has no nodes to delete
+    NotFound,    // No node holds the value
+    OutOfRange   // The position is outside the list
+};
+
+const char* listStatusName(ListStatus status) {
+    switch (status) {
+        case ListStatus::Ok:         return "ok";
+        case ListStatus::Empty:      return "empty";
+        case ListStatus::NotFound:   return "not found";
+        case ListStatus::OutOfRange: return "out of range";
+    }
+    return "?";
+}
+
+// LinkedList class to manage all operations
+// T is the element type and Alloc the allocator nodes are obtained from.
+// NodeAllocator decides how nodes are carved out of Alloc (slabs by
+// default, or one call per node) and Sink receives a report of every
+// insert and delete.
+template <typename T = int,
+          typename Alloc = allocator<T>,
+          template <typename, typename> class NodeAllocator = SlabNodeAllocator,
+          typename Sink = BufferedTextSink>
+class LinkedList {
+private:
+    using ListNode = Node<T>;
+    
+    // Forward iterator over the values; IsConst selects read-only access
+    template <bool IsConst>
+    class Iterator {
+    private:
+        using NodePtr = conditional_t<IsConst, const ListNode*, ListNode*>;
+        NodePtr node;
+        
+        friend class LinkedList;
+        template <bool> friend class Iterator;
+        
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = conditional_t<IsConst, const T*, T*>;
+        using reference = conditional_t<IsConst, const T&, T&>;
+        
+        Iterator() : node(nullptr) {}
+        explicit Iterator(NodePtr start) : node(start) {}
+        
+        // A mutable iterator converts to a const one
+        template <bool OtherConst, typename = enable_if_t<IsConst && !OtherConst>>
+        Iterator(const Iterator<OtherConst>& other) : node(other.node) {}
+        
+        reference operator*() const {
+            return node->data;
+        }
+        
+        pointer operator->() const {
+            return &node->data;
+        }
+        
+        Iterator& operator++() {
+            node = node->next;
+            return *this;
+        }
+        
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            node = node->next;
+            return previous;
+        }
+        
+        friend bool operator==(const Iterator& a, const Iterator& b) {
+            return a.node == b.node;
+        }
+        
+        friend bool operator!=(const Iterator& a, const Iterator& b) {
+            return a.node != b.node;
+        }
+    };
+    
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using reference = T&;
+    using const_reference = const T&;
+    using difference_type = ptrdiff_t;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    
+private:
+    // Whether the element type can use the hash-based value index
+    static constexpr bool hashable = IsHashable<T>::value;
+    
+    NodeAllocator<ListNode, Alloc> nodes;  // Creates and frees every node
+    Sink sink;                             // Receives operation reports
+    ListNode* head;  // Pointer to the first node
+    ListNode* tail;  // Pointer to the last node (makes appends O(1))
+    int size;        // Track the number of nodes
+    
+    // Optional skip list over the chain for O(log n) positional access.
+    // It is built on the first positional call once the list holds at
+    // least `indexThreshold` nodes, and kept in sync from then on.
+    SkipListIndex<ListNode> positionIndex;
+    int indexThreshold;
+    
+    // Optional value -> first occurrence index (see enableValueIndex)
+    using IndexEntry = typename ValueIndex<T, ListNode>::Entry;
+    ValueIndex<T, ListNode> valueIndex;
+    bool valueIndexed;
+    
+    // Progress of an incremental compaction pass (see compactStep)
+    bool compacting;
+    ListNode* compactPrev;  // Last node moved so far (null before the first)
+    int compactPosition;    // Position of the next node to move, -1 if unknown
+    
+#if LIST_METRICS
+    mutable ListMetrics metrics;  // Belongs to this object; never swapped
+#endif
+    
+    // Every node is created and destroyed through these two so metrics
+    // can charge allocations and frees to the running operation
+    template <typename... Args>
+    ListNode* createNode(Args&&... args) {
+        ListNode* node = nodes.create(std::forward<Args>(args)...);
+        LIST_METRICS_ONLY(metrics.allocated();)
+        return node;
+    }
+    
+    template <typename... Args>
+    ListNode* createContiguousNode(Args&&... args) {
+        ListNode* node = nodes.createContiguous(std::forward<Args>(args)...);
+        LIST_METRICS_ONLY(metrics.allocated();)
+        return node;
+    }
+    
+    void destroyNode(ListNode* node) {
+        nodes.destroy(node);
+        LIST_METRICS_ONLY(metrics.freed(1);)
+    }
+    
+    // Render a value for an error message
+    static string describe(const T& value) {
+        ostringstream text;
+        printValue(text, value);
+        return text.str();
+    }
+    
+    // Record that `succ` now hangs off `before` in the value index
+    void indexRelinked(ListNode* before, ListNode* succ) {
+        auto* entry = valueIndex.find(succ->data);
+        if (entry->first == succ) {
+            entry->before = before;
+        }
+        if (entry->count > 1) {
+            valueIndex.occurrence(succ)->before = before;
+        }
+    }
+    
+    // Add `node`, linked in right after `prev`, to the occurrences of its
+    // value between `prevSame` and `nextSame` (either may be null)
+    void indexOccurrence(IndexEntry* entry, ListNode* prev, ListNode* node,
+                         ListNode* prevSame, ListNode* nextSame) {
+        // The value is now held twice: start its occurrence records
+        if (entry->count++ == 1) {
+            valueIndex.addOccurrence(entry->first, {entry->before, nullptr, nullptr});
+        }
+        valueIndex.addOccurrence(node, {prev, prevSame, nextSame});
+        
+        if (prevSame == nullptr) {
+            entry->first = node;
+            entry->before = prev;
+        } else {
+            valueIndex.occurrence(prevSame)->nextSame = node;
+        }
+        if (nextSame == nullptr) {
+            entry->last = node;
+        } else {
+            valueIndex.occurrence(nextSame)->prevSame = node;
+        }
+    }
+    
+    // Index `node`, linked in after `prev`, when it follows every node
+    // indexed so far (bulk appends and rebuilds)
+    void indexAppended(ListNode* prev, ListNode* node) {
+        auto* entry = valueIndex.find(node->data);
+        if (entry == nullptr) {
+            valueIndex.insert(node, prev);
+        } else {
+            indexOccurrence(entry, prev, node, entry->last, nullptr);
+        }
+    }
+    
+    // Update the value index after `node` was linked in right after `prev`
+    void indexLinked(ListNode* prev, ListNode* node) {
+        // The following node now hangs off `node`
+        ListNode* succ = node->next;
+        if (succ != nullptr) {
+            indexRelinked(node, succ);
+        }
+        
+        auto* entry = valueIndex.find(node->data);
+        if (entry == nullptr) {
+            valueIndex.insert(node, prev);
+            return;
+        }
+        
+        // Find the occurrence `node` now comes right before: the old first
+        // at the front, none at the tail, otherwise the next equal node on
+        ListNode* nextSame = nullptr;
+        if (prev == nullptr) {
+            nextSame = entry->first;
+        } else if (node != tail) {
+            for (ListNode* temp = succ; temp != nullptr; temp = temp->next) {
+                if (temp->data == node->data) {
+                    nextSame = temp;
+                    break;
+                }
+            }
+        }
+        
+        ListNode* prevSame = entry->last;
+        if (nextSame != nullptr) {
+            auto* record = valueIndex.occurrence(nextSame);
+            prevSame = (record == nullptr) ? nullptr : record->prevSame;
+        }
+        indexOccurrence(entry, prev, node, prevSame, nextSame);
+    }
+    
+    // Update the value index after `node` was unlinked from after `prev`
+    // (node->next must still point to its old successor)
+    void indexUnlinked(ListNode* prev, ListNode* node) {
+        ListNode* succ = node->next;
+        if (succ != nullptr) {
+            indexRelinked(prev, succ);
+        }
+        
+        auto* entry = valueIndex.find(node->data);
+        if (entry->count == 1) {
+            valueIndex.erase(entry);
+            return;
+        }
+        
+        // Take `node` out of its value's occurrences; when it was the
+        // first, the next occurrence (and its predecessor) take over
+        auto record = *valueIndex.occurrence(node);
+        valueIndex.dropOccurrence(node);
+        if (record.prevSame == nullptr) {
+            entry->first = record.nextSame;
+            entry->before = valueIndex.occurrence(record.nextSame)->before;
+        } else {
+            valueIndex.occurrence(record.prevSame)->nextSame = record.nextSame;
+        }
+        if (record.nextSame == nullptr) {
+            entry->last = record.prevSame;
+        } else {
+            valueIndex.occurrence(record.nextSame)->prevSame = record.prevSame;
+        }
+        
+        // A value held only once more needs no occurrence records
+        if (--entry->count == 1) {
+            valueIndex.dropOccurrence(entry->first);
+        }
+    }
+    
+    // Link `node` in after `prev` (at the front when prev is null) as the
+    // node at `position`, keeping tail, size and both indexes in sync
+    void linkAfter(ListNode* prev, ListNode* node, int position) {
+        if (prev == nullptr) {
+            node->next = head;
+            head = node;
+        } else {
+            node->next = prev->next;
+            prev->next = node;
+        }
+        if (prev == tail) {
+            tail = node;
+        }
+        
+        // A node linked in ahead of the compaction cursor shifts it along
+        if (compacting && compactPosition >= 0 && position < compactPosition) {
+            compactPosition++;
+        }
+        
+        if (positionIndex.active()) {
+            positionIndex.onInsert(position, node);
+            LIST_METRICS_ONLY(metrics.visit(positionIndex.takeVisited());)
+        }
+        if constexpr (hashable) {
+            if (valueIndexed) {
+                indexLinked(prev, node);
+            }
+        }
+        size++;
+    }
+    
+    // Unlink the node after `prev` (the head when prev is null) and return
+    // it. A negative position means "unknown" and drops the skip list.
+    ListNode* unlinkAfter(ListNode* prev, int position) {
+        ListNode* node = (prev == nullptr) ? head : prev->next;
+        if (prev == nullptr) {
+            head = node->next;
+        } else {
+            prev->next = node->next;
+        }
+        
+        // Deleting the last node makes its predecessor the new tail
+        if (node == tail) {
+            tail = prev;
+        }
+        
+        // Keep the compaction cursor on a live node at a known position
+        if (compacting) {
+            if (node == compactPrev) {
+                compactPrev = prev;
+            }
+            if (position < 0) {
+                compactPosition = -1;
+            } else if (position < compactPosition) {
+                compactPosition--;
+            }
+        }
+        
+        if (position < 0) {
+            // Let the next positional call rebuild the skip list instead
+            // of scanning for the position here
+            positionIndex.reset();
+        } else if (positionIndex.active()) {
+            positionIndex.onErase(position);
+            LIST_METRICS_ONLY(metrics.visit(positionIndex.takeVisited());)
+        }
+        if constexpr (hashable) {
+            if (valueIndexed) {
+                indexUnlinked(prev, node);
+            }
+        }
+        size--;
+        return node;
+    }
+    
+    // Index every node from scratch (after a bulk relink)
+    void rebuildValueIndex() {
+        valueIndex.clear();
+        ListNode* prev = nullptr;
+        for (ListNode* temp = head; temp != nullptr; prev = temp, temp = temp->next) {
+            indexAppended(prev, temp);
+        }
+    }
+    
+    // Bring both indexes up to date after a batch changed many links:
+    // the skip list is rebuilt lazily, the value index right away
+    void afterBatch() {
+        positionIndex.reset();
+        compacting = false;
+        if constexpr (hashable) {
+            if (valueIndexed) {
+                rebuildValueIndex();
+            }
+        }
+    }
+    
+    // Build the positional index if the list has grown large enough, and
+    // report whether it is available
+    bool ensurePositionIndex() {
+        if (!positionIndex.active() && indexThreshold >= 0 && size >= indexThreshold) {
+            positionIndex.build(head, size);
+            
+            // The index needs to know where compaction stands; a full walk
+            // costs no more than the build that was just done
+            if (compacting && compactPosition < 0) {
+                compactPosition = 0;
+                if (compactPrev != nullptr) {
+                    for (ListNode* temp = head; temp != compactPrev; temp = temp->next) {
+                        compactPosition++;
+                    }
+                    compactPosition++;
+                }
+            }
+        }
+        return positionIndex.active();
+    }
+    
+    // Find the node just before `position` (position must be >= 1)
+    ListNode* nodeBefore(int position) {
+        if (ensurePositionIndex()) {
+            ListNode* node = positionIndex.nodeBefore(position, head);
+            LIST_METRICS_ONLY(metrics.visit(positionIndex.takeVisited());)
+            return node;
+        }
+        
+        // Small list: a plain walk is cheaper than keeping an index
+        ListNode* temp = head;
+        for (int i = 0; i < position - 1; i++) {
+            temp = temp->next;
+        }
+        LIST_METRICS_ONLY(metrics.visit(position);)
+        return temp;
+    }
+    
+    // nodeBefore() for operations that throw the positional index away
+    // afterwards: an index that is already built is used, but one is never
+    // built just for this lookup
+    ListNode* findBefore(int position) {
+        if (positionIndex.active()) {
+            return nodeBefore(position);
+        }
+        ListNode* temp = head;
+        for (int i = 0; i < position - 1; i++) {
+            prefetchNode(temp->next);
+            temp = temp->next;
+        }
+        LIST_METRICS_ONLY(metrics.visit(position);)
+        return temp;
+    }
+    
+    // Detach the chain after its first `count` nodes and return the rest;
+    // `last` receives the final node kept (null for an empty chain)
+    static ListNode* cutAfter(ListNode* first, int count, ListNode*& last) {
+        last = first;
+        if (first == nullptr) {
+            return nullptr;
+        }
+        for (int i = 1; i < count && last->next != nullptr; i++) {
+            last = last->next;
+        }
+        ListNode* rest = last->next;
+        last->next = nullptr;
+        return rest;
+    }
+    
+    // Merge two sorted chains by relinking only. Ties take the node from
+    // `a`, which keeps the merge stable; `last` receives the merged tail.
+    template <typename Compare>
+    static ListNode* mergeChains(ListNode* a, ListNode* aLast, ListNode* b, ListNode* bLast,
+                                 Compare& comp, ListNode*& last) {
+        ListNode* merged = nullptr;
+        ListNode** link = &merged;
+        
+        while (a != nullptr && b != nullptr) {
+            if (comp(b->data, a->data)) {
+                *link = b;
+                b = b->next;
+            } else {
+                *link = a;
+                a = a->next;
+            }
+            link = &(*link)->next;
+        }
+        
+        // Whatever is left is already in order and already ends at its tail
+        if (a != nullptr) {
+            *link = a;
+            last = aLast;
+        } else {
+            *link = b;
+            last = bLast;
+        }
+        return merged;
+    }
+    
+    // Stable bottom-up merge sort of a chain of `length` nodes: runs of
+    // width 1, 2, 4, ... are merged pairwise, with no recursion and no
+    // allocation. `last` receives the new tail.
+    template <typename Compare>
+    static ListNode* sortChain(ListNode* first, int length, Compare& comp, ListNode*& last) {
+        // Already ordered chains (a common case) cost one pass
+        last = first;
+        bool ordered = true;
+        for (ListNode* temp = first; temp != nullptr && temp->next != nullptr; temp = temp->next) {
+            if (comp(temp->next->data, temp->data)) {
+                ordered = false;
+                break;
+            }
+        }
+        if (ordered) {
+            while (last != nullptr && last->next != nullptr) {
+                last = last->next;
+            }
+            return first;
+        }
+        
+        for (int width = 1; width < length; width *= 2) {
+            ListNode* rest = first;
+            ListNode* merged = nullptr;
+            ListNode** link = &merged;
+            
+            while (rest != nullptr) {
+                ListNode* leftLast;
+                ListNode* rightLast;
+                ListNode* left = rest;
+                ListNode* right = cutAfter(left, width, leftLast);
+                rest = cutAfter(right, width, rightLast);
+                
+                *link = mergeChains(left, leftLast, right, rightLast, comp, last);
+                link = &last->next;
+            }
+            first = merged;
+        }
+        return first;
+    }
+    
+    // Take every node of `other` as a detached chain, leaving it empty.
+    // Nodes are relinked as they are when the allocators can share storage;
+    // otherwise each value is moved into a node from this list's allocator.
+    ListNode* takeChain(LinkedList& other, ListNode*& last) {
+        ListNode* first = other.head;
+        last = other.tail;
+        
+        if (!nodes.adopt(other.nodes)) {
+            first = nullptr;
+            last = nullptr;
+            try {
+                for (ListNode* temp = other.head; temp != nullptr; temp = temp->next) {
+                    ListNode* newNode = createNode(std::move(temp->data));
+                    if (last == nullptr) {
+                        first = newNode;
+                    } else {
+                        last->next = newNode;
+                    }
+                    last = newNode;
+                }
+            } catch (...) {
+                while (first != nullptr) {
+                    ListNode* temp = first;
+                    first = first->next;
+                    destroyNode(temp);
+                }
+                throw;
+            }
+            other.clear();
+        }
+        
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.size = 0;
+        other.positionIndex.reset();
+        other.valueIndex.clear();
+        other.compacting = false;
+        return first;
+    }
+    
+    // Detach `count` (>= 1) nodes of `other` starting at position `first`
+    // and return them as a chain this list's allocator answers for (`last`
+    // receives its final node). The nodes are relinked as they are when the
+    // allocators can share memory; otherwise their values are moved into
+    // new nodes.
+    ListNode* takeRange(LinkedList& other, int first, int count, ListNode*& last) {
+        ListNode* before = (first == 0) ? nullptr : other.findBefore(first);
+        ListNode* start = (before == nullptr) ? other.head : before->next;
+        last = (first + count == other.size) ? other.tail : other.findBefore(first + count);
+        ListNode* after = last->next;
+        
+        ListNode* moved = nullptr;
+        ListNode* movedLast = nullptr;
+        if (!nodes.share(other.nodes, count)) {
+            try {
+                for (ListNode* temp = start; temp != after; temp = temp->next) {
+                    ListNode* newNode = createNode(std::move(temp->data));
+                    if (movedLast == nullptr) {
+                        moved = newNode;
+                    } else {
+                        movedLast->next = newNode;
+                    }
+                    movedLast = newNode;
+                }
+            } catch (...) {
+                while (moved != nullptr) {
+                    ListNode* temp = moved;
+                    moved = moved->next;
+                    destroyNode(temp);
+                }
+                throw;
+            }
+        }
+        
+        if (before == nullptr) {
+            other.head = after;
+        } else {
+            before->next = after;
+        }
+        if (after == nullptr) {
+            other.tail = before;
+        }
+        other.size -= count;
+        last->next = nullptr;
+        
+        if (moved != nullptr) {
+            while (start != nullptr) {
+                ListNode* temp = start;
+                start = start->next;
+                other.destroyNode(temp);
+            }
+            start = moved;
+            last = movedLast;
+        }
+        other.afterBatch();
+        return start;
+    }
+    
+    // Link the chain first..last of `count` nodes in after `before` (at the
+    // front when before is null). A chain added at the end leaves every
+    // existing position alone, so both indexes are extended over the new
+    // nodes in O(count) instead of being rebuilt.
+    void linkChain(ListNode* before, ListNode* first, ListNode* last, int count) {
+        ListNode* after = (before == nullptr) ? head : before->next;
+        last->next = after;
+        if (before == nullptr) {
+            head = first;
+        } else {
+            before->next = first;
+        }
+        
+        if (after != nullptr) {
+            size += count;
+            afterBatch();
+            return;
+        }
+        
+        tail = last;
+        if (positionIndex.active()) {
+            positionIndex.append(first, count);
+            LIST_METRICS_ONLY(metrics.visit(count);)
+        }
+        if constexpr (hashable) {
+            if (valueIndexed) {
+                ListNode* prev = before;
+                for (ListNode* temp = first; temp != nullptr; prev = temp, temp = temp->next) {
+                    indexAppended(prev, temp);
+                }
+            }
+        }
+        size += count;
+    }
+    
+    // Node a chain inserted at `position` (0..size) goes after; the tail
+    // is known without a walk
+    ListNode* insertionPoint(int position) {
+        if (position == 0) {
+            return nullptr;
+        }
+        return (position == size) ? tail : findBefore(position);
+    }
+    
+public:
+    // Lists shorter than this never build the positional index
+    static constexpr int defaultIndexThreshold = 256;
+    
+    // parallelSort() gives each thread at least this many nodes
+    static constexpr int minParallelSegment = 4096;
+    
+    // Constructor initializes empty list
+    explicit LinkedList(Sink eventSink = Sink(), const Alloc& alloc = Alloc())
+        : nodes(alloc), sink(eventSink), head(nullptr), tail(nullptr), size(0),
+          indexThreshold(defaultIndexThreshold), valueIndexed(false),
+          compacting(false), compactPrev(nullptr), compactPosition(0) {}
+    
+    // Copy constructor makes an independent deep copy of every value
+    LinkedList(const LinkedList& other) : LinkedList(other.sink) {
+        appendRange(other.begin(), other.end());
+        indexThreshold = other.indexThreshold;
+        if constexpr (hashable) {
+            if (other.valueIndexed) {
+                enableValueIndex();
+            }
+        }
+    }
+    
+    // Move constructor takes over the other list's nodes in O(1)
+    LinkedList(LinkedList&& other) noexcept : LinkedList(other.sink) {
+        swap(other);
+    }
+    
+    LinkedList& operator=(const LinkedList& other) {
+        if (this != &other) {
+            LinkedList copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+    
+    // Move assignment frees this list's nodes and takes over the other's
+    LinkedList& operator=(LinkedList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+    
+    // Destructor to free all allocated memory
+    ~LinkedList() {
+        clear();
+    }
+    
+    // Exchange the contents of two lists in O(1)
+    void swap(LinkedList& other) noexcept {
+        using std::swap;
+        nodes.swap(other.nodes);
+        swap(sink, other.sink);
+        swap(head, other.head);
+        swap(tail, other.tail);
+        swap(size, other.size);
+        positionIndex.swap(other.positionIndex);
+        swap(indexThreshold, other.indexThreshold);
+        valueIndex.swap(other.valueIndex);
+        swap(valueIndexed, other.valueIndexed);
+        swap(compacting, other.compacting);
+        swap(compactPrev, other.compactPrev);
+        swap(compactPosition, other.compactPosition);
+    }
+    
+    // The relinking operations below move nodes between lists without
+    // allocating or copying values (unless the two lists' allocators cannot
+    // free each other's memory, in which case values are moved into new
+    // nodes). Each costs the walk to the positions involved (O(log n) if the
+    // list is already indexed) plus O(1) for the relink. Nodes moved to the
+    // end of a list extend its indexes over them; otherwise the positional
+    // index is rebuilt on demand afterwards and a value index immediately.
+    // Source lists are left valid, and empty where everything was taken.
+    
+    // Move every node of `other` in front of `position` (0..size)
+    void splice(int position, LinkedList& other) {
+        LIST_METRICS_SCOPE(Splice);
+        
+        if (this == &other) {
+            throw runtime_error("Cannot splice a list into itself!");
+        }
+        if (position < 0 || position > size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size));
+        }
+        if (other.head == nullptr) {
+            return;
+        }
+        
+        ListNode* before = insertionPoint(position);
+        int count = other.size;
+        ListNode* last;
+        ListNode* first = takeChain(other, last);
+        linkChain(before, first, last, count);
+    }
+    
+    // Move `count` nodes of `other` starting at `first` in front of
+    // `position`. Positions refer to the lists before the call; within one
+    // list the range is moved as a block (position must not fall inside it).
+    void spliceRange(int position, LinkedList& other, int first, int count) {
+        LIST_METRICS_SCOPE(Splice);
+        
+        if (position < 0 || position > size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size));
+        }
+        if (first < 0 || count < 0 || count > other.size - first) {
+            throw out_of_range("Invalid range! " + to_string(count) + " nodes from position "
+                               + to_string(first) + " do not fit in " + to_string(other.size));
+        }
+        if (this == &other && position > first && position < first + count) {
+            throw out_of_range("Invalid position! Cannot move a range inside itself");
+        }
+        if (count == 0 || (this == &other && (position == first || position == first + count))) {
+            return;
+        }
+        
+        // The destination node survives the detach even within one list
+        ListNode* before = insertionPoint(position);
+        ListNode* last;
+        ListNode* chain = takeRange(other, first, count, last);
+        linkChain(before, chain, last, count);
+    }
+    
+    // Split off the nodes from `position` (0..size) onward into a new list,
+    // which inherits this list's sink, allocator and index settings
+    LinkedList splitAt(int position) {
+        LIST_METRICS_SCOPE(Splice);
+        
+        if (position < 0 || position > size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size));
+        }
+        
+        LinkedList rest(sink, nodes.allocator());
+        rest.indexThreshold = indexThreshold;
+        if constexpr (hashable) {
+            if (valueIndexed) {
+                rest.enableValueIndex();
+            }
+        }
+        if (position < size) {
+            int count = size - position;
+            ListNode* last;
+            ListNode* chain = rest.takeRange(*this, position, count, last);
+            rest.linkChain(nullptr, chain, last, count);
+        }
+        return rest;
+    }
+    
+    // Append every node of `other` through the tail pointer: the relink is
+    // O(1), plus O(size of other) to extend whichever indexes are enabled
+    void concat(LinkedList& other) {
+        splice(size, other);
+    }
+    
+    // Build a value in place at the beginning of the list
+    template <typename... Args>
+    T& emplace_front(Args&&... args) {
+        LIST_METRICS_SCOPE(InsertAtBeginning);
+        
+        ListNode* newNode = createNode(std::forward<Args>(args)...);
+        linkAfter(nullptr, newNode, 0);
+        sink.record(ListEvent::InsertedAtBeginning, newNode->data, 0);
+        return newNode->data;
+    }
+    
+    // Build a value in place at the end of the list
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        LIST_METRICS_SCOPE(InsertAtEnd);
+        
+        ListNode* newNode = createNode(std::forward<Args>(args)...);
+        bool wasEmpty = (head == nullptr);
+        
+        // Link directly after the tail - no traversal needed
+        linkAfter(tail, newNode, size);
+        if (wasEmpty) {
+            sink.record(ListEvent::InsertedIntoEmpty, newNode->data, 0);
+        } else {
+            sink.record(ListEvent::InsertedAtEnd, newNode->data, size - 1);
+        }
+        return newNode->data;
+    }
+    
+    // Build a value in place at a specific position (0-indexed)
+    template <typename... Args>
+    T& emplace_at(int position, Args&&... args) {
+        LIST_METRICS_SCOPE(InsertAtPosition);
+        
+        // Validate position
+        if (position < 0 || position > size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size));
+        }
+        
+        // If position is 0, insert at beginning
+        if (position == 0) {
+            return emplace_front(std::forward<Args>(args)...);
+        }
+        
+        // If position equals size, insert at end
+        if (position == size) {
+            return emplace_back(std::forward<Args>(args)...);
+        }
+        
+        // Find the node before the insertion point, then create and link
+        ListNode* temp = nodeBefore(position);
+        ListNode* newNode = createNode(std::forward<Args>(args)...);
+        linkAfter(temp, newNode, position);
+        sink.record(ListEvent::InsertedAtPosition, newNode->data, position);
+        return newNode->data;
+    }
+    
+    // Add node at the beginning of the list
+    void insertAtBeginning(T value) {
+        emplace_front(std::move(value));
+    }
+    
+    // Add node at the end of the list
+    void insertAtEnd(T value) {
+        emplace_back(std::move(value));
+    }
+    
+    // Add node at a specific position (0-indexed)
+    void insertAtMiddle(T value, int position) {
+        if (tryInsertAtMiddle(std::move(value), position) != ListStatus::Ok) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size));
+        }
+    }
+    
+    // Non-throwing insertAtMiddle: OutOfRange leaves the list unchanged
+    ListStatus tryInsertAtMiddle(T value, int position) {
+        LIST_METRICS_SCOPE(InsertAtPosition);
+        
+        if (position < 0 || position > size) {
+            LIST_METRICS_ONLY(metricsScope.fail();)
+            return ListStatus::OutOfRange;
+        }
+        emplace_at(position, std::move(value));
+        return ListStatus::Ok;
+    }
+    
+    // Delete node by position (0-indexed)
+    void deleteByPosition(int position) {
+        switch (tryDeleteByPosition(position)) {
+            case ListStatus::Empty:
+                throw runtime_error("Cannot delete from an empty list!");
+            case ListStatus::OutOfRange:
+                throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size - 1));
+            default:
+                break;
+        }
+    }
+    
+    // Non-throwing deleteByPosition: Empty or OutOfRange on a miss
+    ListStatus tryDeleteByPosition(int position) {
+        LIST_METRICS_SCOPE(DeleteAtPosition);
+        
+        // Check if list is empty
+        if (head == nullptr) {
+            LIST_METRICS_ONLY(metricsScope.fail();)
+            return ListStatus::Empty;
+        }
+        
+        // Validate position
+        if (position < 0 || position >= size) {
+            LIST_METRICS_ONLY(metricsScope.fail();)
+            return ListStatus::OutOfRange;
+        }
+        
+        // Find the node before the one to delete (none for the head)
+        ListNode* prev = (position == 0) ? nullptr : nodeBefore(position);
+        ListNode* nodeToDelete = unlinkAfter(prev, position);
+        sink.record(ListEvent::DeletedAtPosition, nodeToDelete->data, position);
+        destroyNode(nodeToDelete);
+        return ListStatus::Ok;
+    }
+    
+    // Delete node by value (deletes first occurrence)
+    void deleteByValue(const T& value) {
+        switch (tryDeleteByValue(value)) {
+            case ListStatus::Empty:
+                throw runtime_error("Cannot delete from an empty list!");
+            case ListStatus::NotFound:
+                throw runtime_error("Value " + describe(value) + " not found in the list!");
+            default:
+                break;
+        }
+    }
+    
+    // Non-throwing deleteByValue: Empty or NotFound on a miss
+    ListStatus tryDeleteByValue(const T& value) {
+        LIST_METRICS_SCOPE(DeleteByValue);
+        
+        // Check if list is empty
+        if (head == nullptr) {
+            LIST_METRICS_ONLY(metricsScope.fail();)
+            return ListStatus::Empty;
+        }
+        
+        // With the value index the first occurrence and its predecessor
+        // are known up front, so neither hits nor misses need a scan
+        if constexpr (hashable) {
+            if (valueIndexed) {
+                auto* entry = valueIndex.find(value);
+                LIST_METRICS_ONLY(metrics.visit(1);)
+                if (entry == nullptr) {
+                    LIST_METRICS_ONLY(metricsScope.fail();)
+                    return ListStatus::NotFound;
+                }
+                
+                // The skip list, if built, finds the node's position by
+                // climbing from it, so it can be updated instead of dropped
+                int position = -1;
+                if (positionIndex.active()) {
+                    position = positionIndex.positionOf(entry->first);
+                    LIST_METRICS_ONLY(metrics.visit(positionIndex.takeVisited());)
+                }
+                ListNode* nodeToDelete = unlinkAfter(entry->before, position);
+                sink.record(ListEvent::DeletedValue, nodeToDelete->data, -1);
+                destroyNode(nodeToDelete);
+                return ListStatus::Ok;
+            }
+        }
+        
+        // Search for the node with the value, tracking its position
+        ListNode* prev = nullptr;
+        ListNode* temp = head;
+        int position = 0;
+        while (temp != nullptr && !(temp->data == value)) {
+            prefetchNode(temp->next);
+            prev = temp;
+            temp = temp->next;
+            position++;
+        }
+        LIST_METRICS_ONLY(metrics.visit(temp == nullptr ? position : position + 1);)
+        
+        // If value not found
+        if (temp == nullptr) {
+            LIST_METRICS_ONLY(metricsScope.fail();)
+            return ListStatus::NotFound;
+        }
+        
+        // Delete the node
+        ListNode* nodeToDelete = unlinkAfter(prev, position);
+        sink.record(ListEvent::DeletedValue, nodeToDelete->data, position);
+        destroyNode(nodeToDelete);
+        return ListStatus::Ok;
+    }
+    
+    // Delete every node whose value satisfies pred in one traversal
+    // Returns how many nodes were deleted (never throws for misses)
+    template <typename Predicate>
+    int removeIf(Predicate pred) {
+        LIST_METRICS_SCOPE(BatchDelete);
+        
+        int removed = 0;
+        int position = 0;
+        ListNode* prev = nullptr;
+        ListNode* temp = head;
+        
+        try {
+            while (temp != nullptr) {
+                ListNode* next = temp->next;
+                prefetchNode(next);
+                if (pred(temp->data)) {
+                    if (prev == nullptr) {
+                        head = next;
+                    } else {
+                        prev->next = next;
+                    }
+                    if (temp == tail) {
+                        tail = prev;
+                    }
+                    sink.record(ListEvent::DeletedValue, temp->data, position);
+                    destroyNode(temp);
+                    size--;
+                    removed++;
+                } else {
+                    prev = temp;
+                    position++;
+                }
+                temp = next;
+            }
+        } catch (...) {
+            // The list itself is consistent up to the throwing node, but the
+            // indexes may still point at nodes that were already destroyed
+            if (removed > 0) {
+                afterBatch();
+            }
+            throw;
+        }
+        LIST_METRICS_ONLY(metrics.visit(position + removed);)
+        
+        if (removed > 0) {
+            afterBatch();
+        }
+        return removed;
+    }
+    
+    // Delete every occurrence of value; returns how many were deleted
+    int deleteAllByValue(const T& value) {
+        return removeIf([&value](const T& candidate) { return candidate == value; });
+    }
+    
+    // Delete every node whose value is in `values` (any container with
+    // count(), such as set or unordered_set); returns how many were deleted
+    template <typename ValueSet>
+    int deleteValues(const ValueSet& values) {
+        return removeIf([&values](const T& candidate) { return values.count(candidate) > 0; });
+    }
+    
+    // Delete the nodes at the given positions of the current list in one
+    // sweep. Positions must be ascending; duplicates and out-of-range
+    // positions are skipped. Returns how many nodes were deleted.
+    int deletePositions(const vector<int>& sortedPositions) {
+        LIST_METRICS_SCOPE(BatchDelete);
+        
+        int removed = 0;
+        int index = 0;  // Position of `temp` in the list before the call
+        ListNode* prev = nullptr;
+        ListNode* temp = head;
+        
+        for (int position : sortedPositions) {
+            if (position < index || position >= size) {
+                continue;
+            }
+            while (index < position) {
+                prev = temp;
+                temp = temp->next;
+                index++;
+            }
+            
+            ListNode* next = temp->next;
+            if (prev == nullptr) {
+                head = next;
+            } else {
+                prev->next = next;
+            }
+            if (temp == tail) {
+                tail = prev;
+            }
+            sink.record(ListEvent::DeletedAtPosition, temp->data, position);
+            destroyNode(temp);
+            removed++;
+            
+            // Positions keep referring to the original list
+            temp = next;
+            index++;
+        }
+        
+        LIST_METRICS_ONLY(metrics.visit(index);)
+        
+        size -= removed;
+        if (removed > 0) {
+            afterBatch();
+        }
+        return removed;
+    }
+    
+    // Insert a batch of (position, value) pairs in one sweep. Positions
+    // refer to the list before the call, so the result is the same as
+    // inserting from the highest position down; values that share a
+    // position keep their batch order. Out-of-range entries are skipped.
+    // Returns how many values were inserted.
+    int insertAtPositions(vector<pair<int, T>> batch) {
+        LIST_METRICS_SCOPE(BatchInsert);
+        
+        stable_sort(batch.begin(), batch.end(),
+                    [](const pair<int, T>& a, const pair<int, T>& b) { return a.first < b.first; });
+        
+        int originalSize = size;
+        int inserted = 0;
+        int index = 0;  // Position of `temp` in the list before the call
+        ListNode* prev = nullptr;
+        ListNode* temp = head;
+        
+        for (auto& item : batch) {
+            int position = item.first;
+            if (position < 0 || position > originalSize) {
+                continue;
+            }
+            while (index < position) {
+                prev = temp;
+                temp = temp->next;
+                index++;
+            }
+            
+            ListNode* newNode = createNode(std::move(item.second));
+            newNode->next = temp;
+            if (prev == nullptr) {
+                head = newNode;
+            } else {
+                prev->next = newNode;
+            }
+            if (temp == nullptr) {
+                tail = newNode;
+            }
+            sink.record(ListEvent::InsertedAtPosition, newNode->data, index + inserted);
+            
+            // Later values at the same position go after this one
+            prev = newNode;
+            inserted++;
+        }
+        
+        LIST_METRICS_ONLY(metrics.visit(index);)
+        
+        size += inserted;
+        if (inserted > 0) {
+            afterBatch();
+        }
+        return inserted;
+    }
+    
+    // Sort the list in place (stable, O(n log n), no allocation). Only the
+    // next pointers are relinked, so values never move in memory.
+    template <typename Compare = less<>>
+    void sort(Compare comp = Compare()) {
+        LIST_METRICS_SCOPE(Sort);
+        
+        if (size < 2) {
+            return;
+        }
+        head = sortChain(head, size, comp, tail);
+        afterBatch();
+    }
+    
+    // Sort using up to `threads` threads: the chain is cut into one segment
+    // per thread, the segments are sorted concurrently and then merged
+    // pairwise (also concurrently) until one run remains. Stable, like
+    // sort(). Each thread uses its own copy of comp, which must not throw.
+    template <typename Compare = less<>>
+    void parallelSort(int threads = static_cast<int>(thread::hardware_concurrency()),
+                      Compare comp = Compare()) {
+        LIST_METRICS_SCOPE(Sort);
+        
+        int segments = min(threads, size / minParallelSegment);
+        if (segments < 2) {
+            sort(comp);
+            return;
+        }
+        
+        // Cut the chain into nearly equal segments
+        vector<ListNode*> firsts(segments);
+        vector<ListNode*> lasts(segments);
+        vector<int> lengths(segments);
+        ListNode* rest = head;
+        for (int s = 0; s < segments; s++) {
+            lengths[s] = size / segments + (s < size % segments ? 1 : 0);
+            firsts[s] = rest;
+            rest = cutAfter(rest, lengths[s], lasts[s]);
+        }
+        
+        // Sort every segment on its own thread (this thread takes the first)
+        vector<thread> workers;
+        for (int s = 1; s < segments; s++) {
+            workers.emplace_back([&, s] {
+                Compare local = comp;
+                firsts[s] = sortChain(firsts[s], lengths[s], local, lasts[s]);
+            });
+        }
+        firsts[0] = sortChain(firsts[0], lengths[0], comp, lasts[0]);
+        for (thread& worker : workers) {
+            worker.join();
+        }
+        
+        // Merge neighbouring runs so equal values keep their order
+        for (int step = 1; step < segments; step *= 2) {
+            workers.clear();
+            for (int s = 0; s + step < segments; s += 2 * step) {
+                workers.emplace_back([&, s, step] {
+                    Compare local = comp;
+                    firsts[s] = mergeChains(firsts[s], lasts[s], firsts[s + step], lasts[s + step],
+                                            local, lasts[s]);
+                });
+            }
+            for (thread& worker : workers) {
+                worker.join();
+            }
+        }
+        
+        head = firsts[0];
+        tail = lasts[0];
+        afterBatch();
+    }
+    
+    // Merge another list sorted by comp into this sorted list in one pass,
+    // leaving `other` empty. Equal values from this list stay in front.
+    template <typename Compare = less<>>
+    void merge(LinkedList& other, Compare comp = Compare()) {
+        LIST_METRICS_SCOPE(Sort);
+        
+        if (this == &other || other.head == nullptr) {
+            return;
+        }
+        
+        int added = other.size;
+        ListNode* otherLast;
+        ListNode* otherFirst = takeChain(other, otherLast);
+        head = mergeChains(head, tail, otherFirst, otherLast, comp, tail);
+        size += added;
+        afterBatch();
+    }
+    
+    // Insert value into a list sorted by comp, after any equal values, and
+    // return its position. Appends and prepends are O(1); other positions
+    // use the skip list (searched by value) on large lists.
+    template <typename Compare = less<>>
+    int sortedInsert(T value, Compare comp = Compare()) {
+        LIST_METRICS_SCOPE(SortedInsert);
+        
+        if (head == nullptr || !comp(value, tail->data)) {
+            emplace_back(std::move(value));
+            return size - 1;
+        }
+        if (comp(value, head->data)) {
+            emplace_front(std::move(value));
+            return 0;
+        }
+        
+        // Find the last node that is not greater than value
+        ListNode* prev;
+        int position;
+        if (ensurePositionIndex()) {
+            prev = positionIndex.lastNotAfter(value, comp, head, position);
+            LIST_METRICS_ONLY(metrics.visit(positionIndex.takeVisited());)
+        } else {
+            prev = head;
+            position = 0;
+            while (!comp(value, prev->next->data)) {
+                prev = prev->next;
+                position++;
+            }
+            LIST_METRICS_ONLY(metrics.visit(position + 2);)
+        }
+        position++;
+        
+        ListNode* newNode = createNode(std::move(value));
+        linkAfter(prev, newNode, position);
+        sink.record(ListEvent::InsertedAtPosition, newNode->data, position);
+        return position;
+    }
+    
+    // Check whether the list is sorted by comp
+    template <typename Compare = less<>>
+    bool isSorted(Compare comp = Compare()) const {
+        for (ListNode* temp = head; temp != nullptr && temp->next != nullptr; temp = temp->next) {
+            if (comp(temp->next->data, temp->data)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    // Move every node into freshly allocated, adjacent storage in list
+    // order and free the old storage, so traversals walk memory front to
+    // back instead of hopping around the heap. Size and order are kept;
+    // values move to new nodes, so iterators and references are invalidated.
+    void compact() {
+        LIST_METRICS_SCOPE(Compact);
+        
+        compacting = false;
+        if (head == nullptr) {
+            return;
+        }
+        
+        NodeAllocator<ListNode, Alloc> fresh(nodes.allocator());
+        fresh.reserve(size);
+        ListNode* first = nullptr;
+        ListNode* last = nullptr;
+        try {
+            for (ListNode* temp = head; temp != nullptr; temp = temp->next) {
+                prefetchNode(temp->next);
+                ListNode* moved = fresh.createContiguous(move_if_noexcept(temp->data));
+                LIST_METRICS_ONLY(metrics.allocated();)
+                if (last == nullptr) {
+                    first = moved;
+                } else {
+                    last->next = moved;
+                }
+                last = moved;
+            }
+        } catch (...) {
+            // A copy threw part way - drop the new chain, keep the old one
+            while (first != nullptr) {
+                ListNode* temp = first;
+                first = first->next;
+                fresh.destroy(temp);
+            }
+            throw;
+        }
+        LIST_METRICS_ONLY(metrics.visit(size);)
+        
+        // Destroy the old nodes, then let `fresh` take the old storage
+        // away with it when it goes out of scope
+        ListNode* old = head;
+        head = first;
+        tail = last;
+        constexpr bool bulkOnly = decltype(nodes)::releasesInBulk && is_trivially_destructible_v<T>;
+        if constexpr (!bulkOnly) {
+            while (old != nullptr) {
+                ListNode* temp = old;
+                old = old->next;
+                destroyNode(temp);
+            }
+        } else {
+            LIST_METRICS_ONLY(metrics.freed(size);)
+        }
+        nodes.swap(fresh);
+        afterBatch();
+    }
+    
+    // Incremental compact(): move up to `budget` nodes into adjacent slots,
+    // carrying on in list order from where the previous call stopped, and
+    // return true once the pass reaches the end of the list. Other
+    // operations may run between calls; a node linked in behind the cursor
+    // waits for the next pass, and batch operations restart the pass. Old
+    // slots return to the allocator for reuse rather than to the system.
+    // Only iterators to the moved nodes are invalidated.
+    bool compactStep(int budget) {
+        LIST_METRICS_SCOPE(Compact);
+        
+        if (!compacting) {
+            // Room for the whole list in one run of slots
+            nodes.reserve(size);
+            compacting = true;
+            compactPrev = nullptr;
+            compactPosition = 0;
+        }
+        
+        for (int moves = 0; moves < budget; moves++) {
+            ListNode* old = (compactPrev == nullptr) ? head : compactPrev->next;
+            if (old == nullptr) {
+                compacting = false;
+                return true;
+            }
+            prefetchNode(old->next);
+            
+            // Find the value index entries that point at `old` while its
+            // value is still there to look them up by
+            IndexEntry* entry = nullptr;
+            IndexEntry* nextEntry = nullptr;
+            if constexpr (hashable) {
+                if (valueIndexed) {
+                    entry = valueIndex.find(old->data);
+                    if (old->next != nullptr) {
+                        nextEntry = valueIndex.find(old->next->data);
+                    }
+                }
+            }
+            
+            ListNode* moved = createContiguousNode(move_if_noexcept(old->data));
+            moved->next = old->next;
+            if (compactPrev == nullptr) {
+                head = moved;
+            } else {
+                compactPrev->next = moved;
+            }
+            if (old == tail) {
+                tail = moved;
+            }
+            
+            if (positionIndex.active()) {
+                positionIndex.replaceNode(compactPosition, moved);
+                LIST_METRICS_ONLY(metrics.visit(positionIndex.takeVisited());)
+            }
+            if (entry != nullptr) {
+                if (entry->first == old) {
+                    entry->first = moved;
+                }
+                if (entry->last == old) {
+                    entry->last = moved;
+                }
+                if (entry->count > 1) {
+                    // Re-key the occurrence record and point its neighbours
+                    // at the new node
+                    auto record = *valueIndex.occurrence(old);
+                    valueIndex.dropOccurrence(old);
+                    valueIndex.addOccurrence(moved, record);
+                    if (record.prevSame != nullptr) {
+                        valueIndex.occurrence(record.prevSame)->nextSame = moved;
+                    }
+                    if (record.nextSame != nullptr) {
+                        valueIndex.occurrence(record.nextSame)->prevSame = moved;
+                    }
+                }
+            }
+            if (nextEntry != nullptr) {
+                if (nextEntry->before == old) {
+                    nextEntry->before = moved;
+                }
+                if (nextEntry->count > 1) {
+                    valueIndex.occurrence(moved->next)->before = moved;
+                }
+            }
+            
+            destroyNode(old);
+            compactPrev = moved;
+            if (compactPosition >= 0) {
+                compactPosition++;
+            }
+            LIST_METRICS_ONLY(metrics.visit(1);)
+        }
+        
+        // Budget used up; report completion if nothing is left
+        if ((compactPrev == nullptr ? head : compactPrev->next) == nullptr) {
+            compacting = false;
+            return true;
+        }
+        return false;
+    }
+    
+    // Check whether an incremental compaction pass is under way
+    bool isCompacting() const {
+        return compacting;
+    }
+    
+    // Display all nodes in the list
+    void display(ostream& os = output) const {
+        LIST_METRICS_SCOPE(Display);
+        
+        if (head == nullptr) {
+            os << "List is empty." << '\n';
+            return;
+        }
+        
+        os << "Linked List: ";
+        ListNode* temp = head;
+        while (temp != nullptr) {
+            prefetchNode(temp->next);
+            printValue(os, temp->data);
+            if (temp->next != nullptr) {
+                os << " -> ";
+            }
+            temp = temp->next;
+        }
+        os << " -> NULL" << '\n';
+        os << "Size: " << size << " nodes" << '\n';
+        LIST_METRICS_ONLY(metrics.visit(size);)
+    }
+    
+    // Get the current size of the list
+    int getSize() const {
+        return size;
+    }
+    
+    // Iterators for range-for loops and std algorithms
+    iterator begin() {
+        return iterator(head);
+    }
+    
+    iterator end() {
+        return iterator(nullptr);
+    }
+    
+    const_iterator begin() const {
+        return const_iterator(head);
+    }
+    
+    const_iterator end() const {
+        return const_iterator(nullptr);
+    }
+    
+    const_iterator cbegin() const {
+        return begin();
+    }
+    
+    const_iterator cend() const {
+        return end();
+    }
+    
+    // Access the first and last values (list must not be empty)
+    T& front() {
+        return head->data;
+    }
+    
+    T& back() {
+        return tail->data;
+    }
+    
+    // Check whether any node holds value
+    bool contains(const T& value) {
+        return count(value) > 0;
+    }
+    
+    // Count how many nodes hold value
+    int count(const T& value) {
+        LIST_METRICS_SCOPE(Search);
+        
+        if constexpr (hashable) {
+            if (valueIndexed) {
+                auto* entry = valueIndex.find(value);
+                return entry == nullptr ? 0 : entry->count;
+            }
+        }
+        
+        int matches = 0;
+        for (ListNode* temp = head; temp != nullptr; temp = temp->next) {
+            prefetchNode(temp->next);
+            if (temp->data == value) {
+                matches++;
+            }
+        }
+        LIST_METRICS_ONLY(metrics.visit(size);)
+        return matches;
+    }
+    
+    // Build the value index over the current nodes and keep it in sync
+    // from now on: deleteByValue, contains and count become expected O(1)
+    void enableValueIndex() {
+        static_assert(hashable, "The value index needs std::hash and == for the element type");
+        if (valueIndexed) {
+            return;
+        }
+        valueIndexed = true;
+        rebuildValueIndex();
+    }
+    
+    // Drop the value index and free its table
+    void disableValueIndex() {
+        valueIndexed = false;
+        valueIndex.release();
+    }
+    
+    // Check whether the value index is enabled
+    bool hasValueIndex() const {
+        return valueIndexed;
+    }
+    
+    // Bytes of value index table per node (0 when disabled or empty)
+    double valueIndexBytesPerNode() const {
+        if (!valueIndexed || size == 0) {
+            return 0.0;
+        }
+        return static_cast<double>(valueIndex.memoryBytes()) / size;
+    }
+    
+    // Get the value at a specific position (0-indexed)
+    T& at(int position) {
+        LIST_METRICS_SCOPE(At);
+        
+        if (position < 0 || position >= size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size - 1));
+        }
+        if (position == 0) {
+            return head->data;
+        }
+        if (position == size - 1) {
+            return tail->data;
+        }
+        return nodeBefore(position + 1)->data;
+    }
+    
+    // Lists with at least `threshold` nodes build the positional index on
+    // their next positional call; a negative threshold disables it
+    void setPositionIndexThreshold(int threshold) {
+        indexThreshold = threshold;
+        if (threshold < 0) {
+            positionIndex.reset();
+        }
+    }
+    
+    // Check whether the positional index is currently built
+    bool hasPositionIndex() const {
+        return positionIndex.active();
+    }
+    
+    // Clear all nodes from the list
+    void clear() {
+        LIST_METRICS_SCOPE(Clear);
+        
+        positionIndex.reset();
+        valueIndex.clear();
+        compacting = false;
+        
+        // Values with destructors must be destroyed one by one; trivial
+        // ones can simply disappear with their slabs
+        constexpr bool bulkOnly = decltype(nodes)::releasesInBulk && is_trivially_destructible_v<T>;
+        if constexpr (!bulkOnly) {
+            while (head != nullptr) {
+                ListNode* temp = head;
+                head = head->next;
+                destroyNode(temp);
+            }
+        } else {
+            LIST_METRICS_ONLY(metrics.freed(size);)
+        }
+        if constexpr (decltype(nodes)::releasesInBulk) {
+            // Drop whole slabs instead of freeing node by node
+            nodes.releaseAll();
+        }
+        head = nullptr;
+        tail = nullptr;
+        size = 0;
+    }
+    
+    // Append a whole batch of values in one pass (no printing)
+    // The batch is linked into a private chain first and then attached
+    // to the tail, so the cost is O(batch) regardless of the list size
+    template <typename InputIt>
+    void appendRange(InputIt first, InputIt last) {
+        LIST_METRICS_SCOPE(BatchInsert);
+        
+        ListNode* batchHead = nullptr;
+        ListNode* batchTail = nullptr;
+        int count = 0;
+        
+        try {
+            for (; first != last; ++first) {
+                ListNode* newNode = createNode(*first);
+                if (batchTail == nullptr) {
+                    batchHead = newNode;
+                } else {
+                    batchTail->next = newNode;
+                }
+                batchTail = newNode;
+                count++;
+            }
+        } catch (...) {
+            // Allocation failed part way - free the partial batch so the
+            // list is left exactly as it was
+            while (batchHead != nullptr) {
+                ListNode* temp = batchHead;
+                batchHead = batchHead->next;
+                destroyNode(temp);
+            }
+            throw;
+        }
+        
+        // Nothing to attach for an empty range
+        if (batchHead == nullptr) {
+            return;
+        }
+        
+        // Rather than indexing each node, let the next positional call
+        // rebuild the index in one pass
+        positionIndex.reset();
+        
+        ListNode* prev = tail;
+        if (tail == nullptr) {
+            head = batchHead;
+        } else {
+            tail->next = batchHead;
+        }
+        tail = batchTail;
+        
+        // Appended nodes are never the first occurrence of a known value,
+        // so each one costs a lookup and at most an occurrence record
+        if constexpr (hashable) {
+            if (valueIndexed) {
+                for (ListNode* temp = batchHead; temp != nullptr; prev = temp, temp = temp->next) {
+                    indexAppended(prev, temp);
+                }
+            }
+        }
+        size += count;
+    }
+    
+    // Convenience overload for appending a whole container
+    template <typename Container>
+    void appendRange(const Container& values) {
+        appendRange(std::begin(values), std::end(values));
+    }
+    
+    // Replace the contents of the list with the given values
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        appendRange(first, last);
+    }
+    
+    template <typename Container>
+    void assign(const Container& values) {
+        assign(std::begin(values), std::end(values));
+    }
+    
+    // Write every value to a binary snapshot file in one pass
+    // (values must be trivially copyable; throws runtime_error on I/O errors)
+    void saveSnapshot(const string& path) const {
+        SnapshotWriter<T> writer(path);
+        for (ListNode* temp = head; temp != nullptr; temp = temp->next) {
+            writer.write(temp->data);
+        }
+        writer.close();
+    }
+    
+    // Replace the contents with a snapshot written by saveSnapshot. Node
+    // storage is sized once for the whole file and the values are linked
+    // chunk by chunk straight from the (memory-mapped) file. If the file is
+    // missing or corrupt, runtime_error is thrown and the list is unchanged.
+    void loadSnapshot(const string& path) {
+#if SNAPSHOT_USE_MMAP
+        MappedSnapshot<T> snapshot(path);
+#else
+        SnapshotReader<T> snapshot(path);
+#endif
+        if (snapshot.count() > static_cast<uint64_t>(numeric_limits<int>::max())) {
+            throw runtime_error("Snapshot " + path + " holds too many values for a list!");
+        }
+        
+        // Build the new chain aside so a bad checksum leaves us untouched
+        LinkedList loaded(sink);
+        loaded.nodes.reserve(static_cast<int>(snapshot.count()));
+        snapshot.forEachChunk([&loaded](const T* values, size_t n) {
+            loaded.appendRange(values, values + n);
+        });
+        
+        clear();
+        int loadedSize = loaded.size;
+        head = takeChain(loaded, tail);
+        size = loadedSize;
+        afterBatch();
+    }
+    
+    // Check if list is empty
+    bool isEmpty() const {
+        return head == nullptr;
+    }
+    
+    // Report how the node allocator is being used
+    AllocatorStats allocatorStats() const {
+        return nodes.stats();
+    }
+    
+    // Access the sink that receives operation reports
+    const Sink& eventSink() const {
+        return sink;
+    }
+    
+#if LIST_METRICS
+    // Copy of everything measured since construction or the last reset
+    ListMetrics metricsSnapshot() const {
+        return metrics;
+    }
+    
+    // Start measuring afresh (the high-water mark restarts at the size)
+    void resetMetrics() {
+        metrics.reset(size);
+    }
+#endif
+};
+
+// Lists can be swapped with the usual swap(a, b)
+template <typename T, typename Alloc, template <typename, typename> class NodeAllocator, typename Sink>
+void swap(LinkedList<T, Alloc, NodeAllocator, Sink>& a, LinkedList<T, Alloc, NodeAllocator, Sink>& b) noexcept {
+    a.swap(b);
+}
+
+// List of T that reports nothing (for benchmarks and bulk work)
+template <typename T>
+using QuietList = LinkedList<T, allocator<T>, SlabNodeAllocator, NullSink>;
+
+// ============================================================================
+// UNROLLED LINKED LIST
+// ============================================================================
+
+// Compare a chunk of values against a target using the widest SIMD
+// instructions available, falling back to a plain loop otherwise.
+// Returns the index of the first match within the first `count` values,
+// or -1 if there is none. `values` must point to 16 readable ints.
+int findInChunk(const int* values, int count, int target) {
+#if defined(__AVX2__)
+    __m256i wanted = _mm256_set1_epi32(target);
+    __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+    __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + 8));
+    
+    // One bit per lane that matched, low lanes in the low bits
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(low, wanted))))
+                  | static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(high, wanted)))) << 8;
+    
+    // Ignore the unused slots past `count`
+    mask &= (1u << count) - 1;
+    return mask == 0 ? -1 : __builtin_ctz(mask);
+#elif defined(__SSE2__)
+    __m128i wanted = _mm_set1_epi32(target);
+    unsigned mask = 0;
+    for (int i = 0; i < 16; i += 4) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        unsigned lanes = static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(block, wanted))));
+        mask |= lanes << i;
+    }
+    
+    mask &= (1u << count) - 1;
+    return mask == 0 ? -1 : __builtin_ctz(mask);
+#else
+    for (int i = 0; i < count; i++) {
+        if (values[i] == target) {
+            return i;
+        }
+    }
+    return -1;
+#endif
+}
+
+// Unrolled linked list: same public API as LinkedList, but every node
+// (chunk) holds up to 16 values in one 64-byte cache line. Traversals
+// follow one pointer per 16 elements instead of one per element, and value
+// searches compare a whole chunk at once.
+template <typename Sink = BufferedTextSink>
+class UnrolledLinkedList {
+private:
+    static constexpr int chunkCapacity = 16;               // 16 ints = 64 bytes
+    static constexpr int mergeThreshold = chunkCapacity * 3 / 4;
+    
+    struct Chunk {
+        alignas(64) int values[chunkCapacity] = {};
+        int count = 0;
+        Chunk* next = nullptr;
+    };
+    
+    Sink sink;     // Receives operation reports
+    Chunk* head;   // First chunk
+    Chunk* tail;   // Last chunk (for O(1) appends)
+    int size;      // Total number of values
+    int chunks;    // Number of chunks in the chain
+    
+    // Link a fresh chunk after `prev` (or at the front when prev is null)
+    Chunk* addChunkAfter(Chunk* prev) {
+        Chunk* chunk = new Chunk();
+        if (prev == nullptr) {
+            chunk->next = head;
+            head = chunk;
+        } else {
+            chunk->next = prev->next;
+            prev->next = chunk;
+        }
+        if (tail == prev) {
+            tail = chunk;
+        }
+        chunks++;
+        return chunk;
+    }
+    
+    // Unlink and free `chunk`, whose predecessor is `prev`
+    void removeChunk(Chunk* prev, Chunk* chunk) {
+        if (prev == nullptr) {
+            head = chunk->next;
+        } else {
+            prev->next = chunk->next;
+        }
+        if (tail == chunk) {
+            tail = prev;
+        }
+        delete chunk;
+        chunks--;
+    }
+    
+    // Insert `value` at `offset` inside `chunk`, splitting it if it is full
+    void insertIntoChunk(Chunk* chunk, int offset, int value) {
+        if (chunk->count == chunkCapacity) {
+            // Move the upper half into a new chunk right after this one
+            Chunk* upper = addChunkAfter(chunk);
+            int half = chunkCapacity / 2;
+            for (int i = half; i < chunkCapacity; i++) {
+                upper->values[i - half] = chunk->values[i];
+            }
+            upper->count = chunkCapacity - half;
+            chunk->count = half;
+            
+            if (offset > half) {
+                chunk = upper;
+                offset -= half;
+            }
+        }
+        
+        // Shift the values after `offset` up by one slot
+        for (int i = chunk->count; i > offset; i--) {
+            chunk->values[i] = chunk->values[i - 1];
+        }
+        chunk->values[offset] = value;
+        chunk->count++;
+        size++;
+    }
+    
+    // Remove the value at `offset` inside `chunk` and rebalance
+    void eraseFromChunk(Chunk* prev, Chunk* chunk, int offset) {
+        for (int i = offset; i < chunk->count - 1; i++) {
+            chunk->values[i] = chunk->values[i + 1];
+        }
+        chunk->count--;
+        size--;
+        
+        if (chunk->count == 0) {
+            removeChunk(prev, chunk);
+            return;
+        }
+        
+        // Merge with the next chunk when both are sparse so the chain
+        // does not degrade into many nearly empty chunks
+        Chunk* next = chunk->next;
+        if (next != nullptr && chunk->count + next->count <= mergeThreshold) {
+            for (int i = 0; i < next->count; i++) {
+                chunk->values[chunk->count + i] = next->values[i];
+            }
+            chunk->count += next->count;
+            removeChunk(chunk, next);
+        }
+    }
+    
+public:
+    // Constructor initializes empty list
+    explicit UnrolledLinkedList(Sink eventSink = Sink())
+        : sink(eventSink), head(nullptr), tail(nullptr), size(0), chunks(0) {}
+    
+    // Destructor to free all chunks
+    ~UnrolledLinkedList() {
+        clear();
+    }
+    
+    // Chunks are owned exclusively - copying would double-free them
+    UnrolledLinkedList(const UnrolledLinkedList&) = delete;
+    UnrolledLinkedList& operator=(const UnrolledLinkedList&) = delete;
+    
+    // Add value at the beginning of the list
+    void insertAtBeginning(int value) {
+        if (head == nullptr) {
+            addChunkAfter(nullptr);
+        }
+        insertIntoChunk(head, 0, value);
+        sink.record(ListEvent::InsertedAtBeginning, value, 0);
+    }
+    
+    // Add value at the end of the list
+    void insertAtEnd(int value) {
+        bool wasEmpty = (head == nullptr);
+        
+        // Start a new chunk instead of splitting a full tail, so
+        // sequential appends leave every chunk completely packed
+        if (wasEmpty || tail->count == chunkCapacity) {
+            addChunkAfter(tail);
+        }
+        tail->values[tail->count++] = value;
+        size++;
+        
+        if (wasEmpty) {
+            sink.record(ListEvent::InsertedIntoEmpty, value, 0);
+        } else {
+            sink.record(ListEvent::InsertedAtEnd, value, size - 1);
+        }
+    }
+    
+    // Add value at a specific position (0-indexed)
+    void insertAtMiddle(int value, int position) {
+        // Validate position
+        if (position < 0 || position > size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size));
+        }
+        
+        if (position == 0) {
+            insertAtBeginning(value);
+            return;
+        }
+        
+        if (position == size) {
+            insertAtEnd(value);
+            return;
+        }
+        
+        // Skip whole chunks until the one containing the position
+        Chunk* chunk = head;
+        int offset = position;
+        while (offset > chunk->count) {
+            offset -= chunk->count;
+            chunk = chunk->next;
+        }
+        
+        insertIntoChunk(chunk, offset, value);
+        sink.record(ListEvent::InsertedAtPosition, value, position);
+    }
+    
+    // Delete value by position (0-indexed)
+    void deleteByPosition(int position) {
+        // Check if list is empty
+        if (head == nullptr) {
+            throw runtime_error("Cannot delete from an empty list!");
+        }
+        
+        // Validate position
+        if (position < 0 || position >= size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size - 1));
+        }
+        
+        Chunk* prev = nullptr;
+        Chunk* chunk = head;
+        int offset = position;
+        while (offset >= chunk->count) {
+            offset -= chunk->count;
+            prev = chunk;
+            chunk = chunk->next;
+        }
+        
+        int value = chunk->values[offset];
+        eraseFromChunk(prev, chunk, offset);
+        sink.record(ListEvent::DeletedAtPosition, value, position);
+    }
+    
+    // Delete value by value (deletes first occurrence)
+    void deleteByValue(int value) {
+        // Check if list is empty
+        if (head == nullptr) {
+            throw runtime_error("Cannot delete from an empty list!");
+        }
+        
+        Chunk* prev = nullptr;
+        for (Chunk* chunk = head; chunk != nullptr; prev = chunk, chunk = chunk->next) {
+            int offset = findInChunk(chunk->values, chunk->count, value);
+            if (offset != -1) {
+                eraseFromChunk(prev, chunk, offset);
+                sink.record(ListEvent::DeletedValue, value, -1);
+                return;
+            }
+        }
+        
+        throw runtime_error("Value " + to_string(value) + " not found in the list!");
+    }
+    
+    // Find the position of the first occurrence of value, or -1
+    int find(int value) const {
+        int base = 0;
+        for (Chunk* chunk = head; chunk != nullptr; chunk = chunk->next) {
+            int offset = findInChunk(chunk->values, chunk->count, value);
+            if (offset != -1) {
+                return base + offset;
+            }
+            base += chunk->count;
+        }
+        return -1;
+    }
+    
+    // Check whether value is stored anywhere in the list
+    bool contains(int value) const {
+        return find(value) != -1;
+    }
+    
+    // Display all values in the list
+    void display(ostream& os = output) const {
+        if (head == nullptr) {
+            os << "List is empty." << '\n';
+            return;
+        }
+        
+        os << "Unrolled List: ";
+        for (Chunk* chunk = head; chunk != nullptr; chunk = chunk->next) {
+            os << "[";
+            for (int i = 0; i < chunk->count; i++) {
+                os << chunk->values[i];
+                if (i < chunk->count - 1) {
+                    os << " ";
+                }
+            }
+            os << "]";
+            if (chunk->next != nullptr) {
+                os << " -> ";
+            }
+        }
+        os << " -> NULL" << '\n';
+        os << "Size: " << size << " values in " << chunks << " chunks" << '\n';
+    }
+    
+    // Get the current size of the list
+    int getSize() const {
+        return size;
+    }
+    
+    // Get the number of chunks in the chain
+    int getChunkCount() const {
+        return chunks;
+    }
+    
+    // Access the sink that receives operation reports
+    const Sink& eventSink() const {
+        return sink;
+    }
+    
+    // Clear all chunks from the list
+    void clear() {
+        while (head != nullptr) {
+            Chunk* temp = head;
+            head = head->next;
+            delete temp;
+        }
+        tail = nullptr;
+        size = 0;
+        chunks = 0;
+    }
+    
+    // Check if list is empty
+    bool isEmpty() const {
+        return head == nullptr;
+    }
+    
+    // Append a whole batch of values in one pass (no printing)
+    template <typename InputIt>
+    void appendRange(InputIt first, InputIt last) {
+        for (; first != last; ++first) {
+            if (tail == nullptr || tail->count == chunkCapacity) {
+                addChunkAfter(tail);
+            }
+            tail->values[tail->count++] = *first;
+            size++;
+        }
+    }
+    
+    template <typename Container>
+    void appendRange(const Container& values) {
+        appendRange(begin(values), end(values));
+    }
+    
+    // Replace the contents of the list with the given values
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        appendRange(first, last);
+    }
+    
+    template <typename Container>
+    void assign(const Container& values) {
+        assign(begin(values), end(values));
+    }
+};
+
+// ============================================================================
+// CONCURRENT (LOCK-FREE) LINKED LIST
+// ============================================================================
+
+// Epoch-based memory reclamation shared by every concurrent list
+// A thread announces the global epoch while it is inside an operation.
+// Unlinked nodes are "retired" into a per-thread limbo bucket tagged with
+// the epoch they were retired in, and freed only once the global epoch is
+// two steps further - by then no thread can still be holding a pointer.
+class EpochReclaimer {
+private:
+    static constexpr int maxThreads = 128;
+    static constexpr int retiresPerAdvance = 64;
+    
+    // A retired node and the function that frees it
+    struct Retired {
+        void* pointer;
+        void (*deleter)(void*);
+    };
+    
+    struct Bucket {
+        unsigned epoch = 0;
+        vector<Retired> nodes;
+    };
+    
+    // One slot per registered thread, each on its own cache line
+    struct alignas(64) Slot {
+        atomic<bool> inUse{false};
+        atomic<bool> active{false};
+        atomic<unsigned> epoch{0};
+    };
+    
+    // Per-thread state: the claimed slot and three limbo buckets
+    struct ThreadState {
+        Slot* slot = nullptr;
+        Bucket limbo[3];
+        int retiredSinceAdvance = 0;
+        
+        ~ThreadState() {
+            if (slot != nullptr) {
+                instance().releaseThread(*this);
+            }
+        }
+    };
+    
+    Slot slots[maxThreads];
+    atomic<unsigned> globalEpoch{2};
+    
+    // Limbo nodes left behind by threads that exited
+    mutex orphanLock;
+    vector<Bucket> orphans;
+    
+    static void freeBucket(Bucket& bucket) {
+        for (const Retired& retired : bucket.nodes) {
+            retired.deleter(retired.pointer);
+        }
+        bucket.nodes.clear();
+    }
+    
+    ThreadState& threadState() {
+        thread_local ThreadState state;
+        if (state.slot == nullptr) {
+            for (Slot& slot : slots) {
+                bool expected = false;
+                if (!slot.inUse.load() && slot.inUse.compare_exchange_strong(expected, true)) {
+                    state.slot = &slot;
+                    break;
+                }
+            }
+            if (state.slot == nullptr) {
+                throw runtime_error("Too many threads using concurrent lists!");
+            }
+        }
+        return state;
+    }
+    
+    void releaseThread(ThreadState& state) {
+        {
+            lock_guard<mutex> lock(orphanLock);
+            for (Bucket& bucket : state.limbo) {
+                if (!bucket.nodes.empty()) {
+                    orphans.push_back(std::move(bucket));
+                }
+            }
+        }
+        state.slot->active.store(false);
+        state.slot->inUse.store(false);
+        state.slot = nullptr;
+    }
+    
+    // Advance the global epoch if every active thread has caught up to it
+    void tryAdvance() {
+        unsigned epoch = globalEpoch.load();
+        for (Slot& slot : slots) {
+            if (slot.inUse.load() && slot.active.load() && slot.epoch.load() != epoch) {
+                return;
+            }
+        }
+        globalEpoch.compare_exchange_strong(epoch, epoch + 1);
+        
+        // Opportunistically free orphaned buckets that are now safe
+        unique_lock<mutex> lock(orphanLock, try_to_lock);
+        if (lock.owns_lock()) {
+            unsigned now = globalEpoch.load();
+            auto safe = [now](Bucket& bucket) {
+                if (bucket.epoch + 2 <= now) {
+                    freeBucket(bucket);
+                    return true;
+                }
+                return false;
+            };
+            orphans.erase(remove_if(orphans.begin(), orphans.end(), safe), orphans.end());
+        }
+    }
+    
+public:
+    static EpochReclaimer& instance() {
+        static EpochReclaimer reclaimer;
+        return reclaimer;
+    }
+    
+    // Runs at exit, when no other thread can touch retired nodes
+    ~EpochReclaimer() {
+        for (Bucket& bucket : orphans) {
+            freeBucket(bucket);
+        }
+    }
+    
+    // Mark the calling thread as inside an operation
+    void enter() {
+        ThreadState& state = threadState();
+        unsigned epoch = globalEpoch.load();
+        state.slot->epoch.store(epoch);
+        state.slot->active.store(true);
+        
+        // Free any bucket retired at least two epochs ago
+        for (Bucket& bucket : state.limbo) {
+            if (!bucket.nodes.empty() && bucket.epoch + 2 <= epoch) {
+                freeBucket(bucket);
+            }
+        }
+    }
+    
+    // Mark the calling thread as outside any operation
+    void exit() {
+        threadState().slot->active.store(false, memory_order_release);
+    }
+    
+    // Hand over an unlinked node to be freed once no thread can see it
+    void retire(void* pointer, void (*deleter)(void*)) {
+        ThreadState& state = threadState();
+        
+        // Tag with the current global epoch: every thread that might still
+        // see the node announced this epoch or the one before it
+        unsigned epoch = globalEpoch.load();
+        Bucket& bucket = state.limbo[epoch % 3];
+        
+        // A bucket from three epochs back is already safe to free
+        if (bucket.epoch != epoch) {
+            freeBucket(bucket);
+            bucket.epoch = epoch;
+        }
+        bucket.nodes.push_back({pointer, deleter});
+        
+        if (++state.retiredSinceAdvance >= retiresPerAdvance) {
+            state.retiredSinceAdvance = 0;
+            tryAdvance();
+        }
+    }
+};
+
+// RAII guard that keeps the calling thread inside an epoch
+class EpochGuard {
+public:
+    EpochGuard() {
+        EpochReclaimer::instance().enter();
+    }
+    
+    ~EpochGuard() {
+        EpochReclaimer::instance().exit();
+    }
+    
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+// Lock-free singly linked list (Harris-style) that any number of threads
+// can use at the same time. A node is deleted in two steps: first its own
+// next pointer is marked (logical delete, done with one CAS), then it is
+// unlinked from its predecessor. Any traversal that meets a marked node
+// helps unlink it, and unlinked nodes are freed through EpochReclaimer.
+template <typename T>
+class ConcurrentLinkedList {
+private:
+    struct CNode {
+        T data;
+        atomic<uintptr_t> next;  // Successor pointer; low bit = "deleted"
+        
+        explicit CNode(const T& value) : data(value), next(0) {}
+    };
+    
+    static constexpr uintptr_t markBit = 1;
+    
+    static CNode* pointerOf(uintptr_t link) {
+        return reinterpret_cast<CNode*>(link & ~markBit);
+    }
+    
+    static bool isMarked(uintptr_t link) {
+        return (link & markBit) != 0;
+    }
+    
+    static void deleteNode(void* node) {
+        delete static_cast<CNode*>(node);
+    }
+    
+    atomic<uintptr_t> headLink;  // Never marked
+    atomic<long> count;          // Approximate while writers are running
+    
+    // Find the first live node holding `value`. On success `predLink` is
+    // the link that pointed at it and `currLink` its unmarked address.
+    // Marked nodes met on the way are unlinked and retired.
+    bool find(const T& value, atomic<uintptr_t>*& predLink, uintptr_t& currLink) {
+    retry:
+        predLink = &headLink;
+        currLink = predLink->load(memory_order_acquire);
+        
+        while (true) {
+            CNode* curr = pointerOf(currLink);
+            if (curr == nullptr) {
+                return false;
+            }
+            
+            uintptr_t succLink = curr->next.load(memory_order_acquire);
+            if (isMarked(succLink)) {
+                // Help finish a delete; fails if the predecessor changed
+                uintptr_t expected = currLink;
+                if (!predLink->compare_exchange_strong(expected, succLink & ~markBit,
+                                                       memory_order_acq_rel)) {
+                    goto retry;
+                }
+                EpochReclaimer::instance().retire(curr, deleteNode);
+                currLink = succLink & ~markBit;
+                continue;
+            }
+            
+            if (curr->data == value) {
+                return true;
+            }
+            predLink = &curr->next;
+            currLink = succLink;
+        }
+    }
+    
+public:
+    ConcurrentLinkedList() : headLink(0), count(0) {}
+    
+    // Destruction must not race with other threads using the list
+    ~ConcurrentLinkedList() {
+        CNode* node = pointerOf(headLink.load());
+        while (node != nullptr) {
+            CNode* next = pointerOf(node->next.load());
+            delete node;
+            node = next;
+        }
+    }
+    
+    ConcurrentLinkedList(const ConcurrentLinkedList&) = delete;
+    ConcurrentLinkedList& operator=(const ConcurrentLinkedList&) = delete;
+    
+    // Add value at the beginning of the list
+    void insertAtBeginning(const T& value) {
+        CNode* node = new CNode(value);
+        uintptr_t first = headLink.load(memory_order_relaxed);
+        do {
+            node->next.store(first, memory_order_relaxed);
+        } while (!headLink.compare_exchange_weak(first, reinterpret_cast<uintptr_t>(node),
+                                                 memory_order_release, memory_order_relaxed));
+        count.fetch_add(1, memory_order_relaxed);
+    }
+    
+    // Insert value right after the first live node holding `after`
+    // Returns false (and inserts nothing) if `after` is not in the list
+    bool insertAfter(const T& after, const T& value) {
+        EpochGuard guard;
+        CNode* node = new CNode(value);
+        
+        while (true) {
+            atomic<uintptr_t>* predLink;
+            uintptr_t currLink;
+            if (!find(after, predLink, currLink)) {
+                delete node;
+                return false;
+            }
+            
+            CNode* curr = pointerOf(currLink);
+            uintptr_t succLink = curr->next.load(memory_order_acquire);
+            if (isMarked(succLink)) {
+                continue;  // `after` is being deleted - search again
+            }
+            node->next.store(succLink, memory_order_relaxed);
+            if (curr->next.compare_exchange_strong(succLink, reinterpret_cast<uintptr_t>(node),
+                                                   memory_order_release, memory_order_relaxed)) {
+                count.fetch_add(1, memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    
+    // Delete the first live node holding value
+    // Returns false if no such node exists
+    bool deleteByValue(const T& value) {
+        EpochGuard guard;
+        
+        while (true) {
+            atomic<uintptr_t>* predLink;
+            uintptr_t currLink;
+            if (!find(value, predLink, currLink)) {
+                return false;
+            }
+            
+            CNode* curr = pointerOf(currLink);
+            uintptr_t succLink = curr->next.load(memory_order_acquire);
+            if (isMarked(succLink)) {
+                continue;  // Another thread got there first
+            }
+            
+            // Logical delete: whoever marks the node owns the deletion
+            if (!curr->next.compare_exchange_strong(succLink, succLink | markBit,
+                                                    memory_order_acq_rel)) {
+                continue;
+            }
+            count.fetch_sub(1, memory_order_relaxed);
+            
+            // Physical delete; if it fails a later traversal will do it
+            uintptr_t expected = currLink;
+            if (predLink->compare_exchange_strong(expected, succLink, memory_order_acq_rel)) {
+                EpochReclaimer::instance().retire(curr, deleteNode);
+            }
+            return true;
+        }
+    }
+    
+    // Check whether a live node holds value (never writes to the list)
+    bool contains(const T& value) const {
+        EpochGuard guard;
+        CNode* node = pointerOf(headLink.load(memory_order_acquire));
+        while (node != nullptr) {
+            uintptr_t next = node->next.load(memory_order_acquire);
+            if (!isMarked(next) && node->data == value) {
+                return true;
+            }
+            node = pointerOf(next);
+        }
+        return false;
+    }
+    
+    // Number of live nodes (exact once all writers have finished)
+    long getSize() const {
+        return count.load(memory_order_relaxed);
+    }
+    
+    // Copy the live values in order (a consistent view only when quiet)
+    vector<T> snapshot() const {
+        EpochGuard guard;
+        vector<T> values;
+        CNode* node = pointerOf(headLink.load(memory_order_acquire));
+        while (node != nullptr) {
+            uintptr_t next = node->next.load(memory_order_acquire);
+            if (!isMarked(next)) {
+                values.push_back(node->data);
+            }
+            node = pointerOf(next);
+        }
+        return values;
+    }
+};
+
+// Run `work(threadIndex)` on `threads` threads at once and return seconds
+// The first exception thrown by any worker is rethrown after all join
+template <typename Work>
+double runOnThreads(int threads, Work work) {
+    vector<thread> workers;
+    atomic<bool> go(false);
+    
+    mutex errorLock;
+    exception_ptr error;
+    
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            while (!go.load()) {
+                this_thread::yield();
+            }
+            try {
+                work(t);
+            } catch (...) {
+                lock_guard<mutex> lock(errorLock);
+                if (!error) {
+                    error = current_exception();
+                }
+            }
+        });
+    }
+    
+    auto start = chrono::steady_clock::now();
+    go.store(true);
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    
+    if (error) {
+        rethrow_exception(error);
+    }
+    return seconds;
+}
+
+// Scaling benchmark: a mixed workload on 1..maxThreads threads
+// (40% contains, 30% insertAtBeginning, 30% deleteByValue)
+void benchmarkConcurrentList(int maxThreads, int opsPerThread) {
+    output << "\nConcurrent list scaling (" << opsPerThread << " ops per thread, "
+           << thread::hardware_concurrency() << " hardware threads)\n";
+    output << "threads,seconds,million_ops_per_sec\n";
+    
+    // Powers of two up to maxThreads, plus maxThreads itself
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+    
+    for (int threads : threadCounts) {
+        ConcurrentLinkedList<int> list;
+        for (int i = 0; i < 1000; i++) {
+            list.insertAtBeginning(i);
+        }
+        
+        double seconds = runOnThreads(threads, [&list, opsPerThread](int t) {
+            mt19937 rng(1234 + t);
+            for (int i = 0; i < opsPerThread; i++) {
+                int value = static_cast<int>(rng() % 2000);
+                unsigned op = rng() % 10;
+                if (op < 4) {
+                    list.contains(value);
+                } else if (op < 7) {
+                    list.insertAtBeginning(value);
+                } else {
+                    list.deleteByValue(value);
+                }
+            }
+        });
+        
+        double rate = threads * static_cast<double>(opsPerThread) / seconds / 1e6;
+        output << threads << "," << seconds << "," << rate << '\n';
+    }
+    output.flush();
+}
+
+// ============================================================================
+// PERSISTENT (IMMUTABLE) LINKED LIST
+// ============================================================================
+
+// Singly linked list whose versions never change once built. Every update
+// returns a new version that copies the nodes in front of the change and
+// shares the rest with the version it came from, so:
+// - taking a snapshot (copying a version) is O(1)
+// - pushFront/popFront are O(1); an update at position p copies p nodes
+// - a version can be read from any number of threads without locks
+// Nodes are reference counted with atomics and freed when the last version
+// holding them goes away. A single PersistentList object must still not be
+// reassigned while another thread reads it - give each reader its own copy.
+template <typename T>
+class PersistentList {
+private:
+    struct PNode {
+        const T data;
+        PNode* next;           // Set only while the node is being built
+        mutable atomic<int> refs;
+        
+        template <typename... Args>
+        explicit PNode(PNode* successor, Args&&... args)
+            : data(std::forward<Args>(args)...), next(successor), refs(1) {}
+    };
+    
+    PNode* head;
+    int size;
+    
+    PersistentList(PNode* first, int count) : head(first), size(count) {}
+    
+    static PNode* retain(PNode* node) {
+        if (node != nullptr) {
+            node->refs.fetch_add(1, memory_order_relaxed);
+        }
+        return node;
+    }
+    
+    // Drop one reference to `node` and free every node that was only
+    // reachable through it (iteratively, so long chains cannot overflow
+    // the stack)
+    static void release(PNode* node) {
+        while (node != nullptr && node->refs.fetch_sub(1, memory_order_acq_rel) == 1) {
+            PNode* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+    
+    // Node at `position` (which must be valid)
+    PNode* nodeAt(int position) const {
+        PNode* temp = head;
+        for (int i = 0; i < position; i++) {
+            temp = temp->next;
+        }
+        return temp;
+    }
+    
+    // Copy the first `count` nodes in front of `suffix` (whose reference
+    // the new chain takes over) and return the new first node
+    PNode* copyPrefix(int count, PNode* suffix) const {
+        PNode* first = suffix;
+        PNode** link = &first;
+        try {
+            PNode* source = head;
+            for (int i = 0; i < count; i++) {
+                *link = new PNode(suffix, source->data);
+                link = &(*link)->next;
+                source = source->next;
+            }
+        } catch (...) {
+            release(first);
+            throw;
+        }
+        return first;
+    }
+    
+    static string describe(const T& value) {
+        ostringstream text;
+        printValue(text, value);
+        return text.str();
+    }
+    
+public:
+    // Read-only forward iterator over one version
+    class const_iterator {
+    private:
+        const PNode* node;
+        
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = T;
+        using difference_type = ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+        
+        explicit const_iterator(const PNode* start = nullptr) : node(start) {}
+        
+        reference operator*() const {
+            return node->data;
+        }
+        
+        pointer operator->() const {
+            return &node->data;
+        }
+        
+        const_iterator& operator++() {
+            node = node->next;
+            return *this;
+        }
+        
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            node = node->next;
+            return previous;
+        }
+        
+        bool operator==(const const_iterator& other) const {
+            return node == other.node;
+        }
+        
+        bool operator!=(const const_iterator& other) const {
+            return node != other.node;
+        }
+    };
+    
+    PersistentList() : head(nullptr), size(0) {}
+    
+    // Build a version holding the values of [first, last) in order
+    template <typename It>
+    PersistentList(It first, It last) : head(nullptr), size(0) {
+        PNode** link = &head;
+        try {
+            for (; first != last; ++first) {
+                *link = new PNode(nullptr, *first);
+                link = &(*link)->next;
+                size++;
+            }
+        } catch (...) {
+            release(head);
+            throw;
+        }
+    }
+    
+    // Copying a version is an O(1) snapshot: both share every node
+    PersistentList(const PersistentList& other) : head(retain(other.head)), size(other.size) {}
+    
+    PersistentList(PersistentList&& other) noexcept : head(other.head), size(other.size) {
+        other.head = nullptr;
+        other.size = 0;
+    }
+    
+    PersistentList& operator=(PersistentList other) noexcept {
+        swap(other);
+        return *this;
+    }
+    
+    ~PersistentList() {
+        release(head);
+    }
+    
+    void swap(PersistentList& other) noexcept {
+        using std::swap;
+        swap(head, other.head);
+        swap(size, other.size);
+    }
+    
+    // Same version under another name (for readability at call sites)
+    PersistentList snapshot() const {
+        return *this;
+    }
+    
+    // New version with value in front (O(1), shares every node)
+    template <typename... Args>
+    PersistentList pushFront(Args&&... args) const {
+        PNode* node = new PNode(head, std::forward<Args>(args)...);
+        retain(head);
+        return PersistentList(node, size + 1);
+    }
+    
+    // New version without the first value (O(1), shares every other node)
+    PersistentList popFront() const {
+        if (head == nullptr) {
+            throw runtime_error("Cannot delete from an empty list!");
+        }
+        return PersistentList(retain(head->next), size - 1);
+    }
+    
+    // New version with value at `position` (0..size); copies the first
+    // `position` nodes and shares the rest
+    PersistentList insertAt(int position, const T& value) const {
+        if (position < 0 || position > size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size));
+        }
+        PNode* after = retain(nodeAt(position));
+        PNode* node;
+        try {
+            node = new PNode(after, value);
+        } catch (...) {
+            release(after);
+            throw;
+        }
+        return PersistentList(copyPrefix(position, node), size + 1);
+    }
+    
+    // New version with value at the end (copies every node)
+    PersistentList pushBack(const T& value) const {
+        return insertAt(size, value);
+    }
+    
+    // New version without the value at `position`; copies the nodes in
+    // front of it and shares the rest
+    PersistentList deleteAt(int position) const {
+        if (head == nullptr) {
+            throw runtime_error("Cannot delete from an empty list!");
+        }
+        if (position < 0 || position >= size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size - 1));
+        }
+        PNode* after = retain(nodeAt(position)->next);
+        return PersistentList(copyPrefix(position, after), size - 1);
+    }
+    
+    // New version without the first occurrence of value
+    PersistentList deleteByValue(const T& value) const {
+        if (head == nullptr) {
+            throw runtime_error("Cannot delete from an empty list!");
+        }
+        int position = find(value);
+        if (position < 0) {
+            throw runtime_error("Value " + describe(value) + " not found in the list!");
+        }
+        return deleteAt(position);
+    }
+    
+    // Position of the first occurrence of value, or -1
+    int find(const T& value) const {
+        int position = 0;
+        for (const PNode* temp = head; temp != nullptr; temp = temp->next) {
+            if (temp->data == value) {
+                return position;
+            }
+            position++;
+        }
+        return -1;
+    }
+    
+    // Check whether any node holds value
+    bool contains(const T& value) const {
+        return find(value) >= 0;
+    }
+    
+    // Access the first value (list must not be empty)
+    const T& front() const {
+        return head->data;
+    }
+    
+    // Get the value at a specific position (0-indexed)
+    const T& at(int position) const {
+        if (position < 0 || position >= size) {
+            throw out_of_range("Invalid position! Position must be between 0 and " + to_string(size - 1));
+        }
+        return nodeAt(position)->data;
+    }
+    
+    // Get the number of values in this version
+    int getSize() const {
+        return size;
+    }
+    
+    bool isEmpty() const {
+        return head == nullptr;
+    }
+    
+    // True when both versions start at the same node (and so hold the
+    // same values without comparing them)
+    bool sharesWith(const PersistentList& other) const {
+        return head == other.head;
+    }
+    
+    const_iterator begin() const {
+        return const_iterator(head);
+    }
+    
+    const_iterator end() const {
+        return const_iterator();
+    }
+    
+    // Print this version
+    void display(ostream& os = output) const {
+        if (head == nullptr) {
+            os << "List is empty." << '\n';
+            return;
+        }
+        
+        os << "Persistent List: ";
+        for (const PNode* temp = head; temp != nullptr; temp = temp->next) {
+            printValue(os, temp->data);
+            if (temp->next != nullptr) {
+                os << " -> ";
+            }
+        }
+        os << " -> NULL" << '\n';
+        os << "Size: " << size << " nodes" << '\n';
+    }
+};
+
+template <typename T>
+void swap(PersistentList<T>& a, PersistentList<T>& b) noexcept {
+    a.swap(b);
+}
+
+// ============================================================================
+// BENCHMARK SUITE
+// ============================================================================
+
+// Every call to the global operator new bumps the calling thread's counter,
+// so allocations/op covers nodes, index lanes and vector growth alike. The
+// counter is per thread to keep concurrent code free of a shared hot spot.
+thread_local long long heapAllocations = 0;
+
+// GCC can't tell that these malloc/free pairs are matched
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t bytes) {
+    heapAllocations++;
+    if (void* memory = malloc(bytes == 0 ? 1 : bytes)) {
+        return memory;
+    }
+    throw bad_alloc();
+}
+
+// The remaining (non-aligned) forms route through the two above so that
+// every new is paired with a matching delete
+void* operator new[](size_t bytes) {
+    return operator new(bytes);
+}
+
+void* operator new(size_t bytes, const nothrow_t&) noexcept {
+    try {
+        return operator new(bytes);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t bytes, const nothrow_t&) noexcept {
+    return operator new(bytes, nothrow);
+}
+
+void operator delete(void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, size_t) noexcept {
+    free(memory);
+}
+
+void operator delete(void* memory, const nothrow_t&) noexcept {
+    free(memory);
+}
+
+void operator delete[](void* memory, const nothrow_t&) noexcept {
+    free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+// Stream target that throws away everything written to it, so display()
+// can be timed without measuring a terminal
+class DiscardBuffer : public streambuf {
+private:
+    char scratch[4096];
+    
+protected:
+    int overflow(int c) override {
+        setp(scratch, scratch + sizeof(scratch));
+        return traits_type::not_eof(c);
+    }
+    
+public:
+    DiscardBuffer() {
+        setp(scratch, scratch + sizeof(scratch));
+    }
+};
+
+// Where positional operations land in the list
+enum class AccessPattern {
+    HeadHeavy,  // Within 16 nodes of the front
+    TailHeavy,  // Within 16 nodes of the back
+    Uniform,    // Anywhere, equally likely
+    Skewed      // Cubed uniform: half of all operations in the first 1/8
+};
+
+const char* patternName(AccessPattern pattern) {
+    switch (pattern) {
+        case AccessPattern::HeadHeavy: return "head";
+        case AccessPattern::TailHeavy: return "tail";
+        case AccessPattern::Uniform:   return "uniform";
+        case AccessPattern::Skewed:    return "skewed";
+    }
+    return "?";
+}
+
+// Pick a position in [0, limit) following the pattern
+int pickPosition(AccessPattern pattern, int limit, mt19937& rng) {
+    int window = min(limit, 16);
+    switch (pattern) {
+        case AccessPattern::HeadHeavy:
+            return static_cast<int>(rng() % window);
+        case AccessPattern::TailHeavy:
+            return limit - 1 - static_cast<int>(rng() % window);
+        case AccessPattern::Uniform:
+            return static_cast<int>(rng() % limit);
+        case AccessPattern::Skewed: {
+            double u = generate_canonical<double, 32>(rng);
+            return min(limit - 1, static_cast<int>(limit * u * u * u));
+        }
+    }
+    return 0;
+}
+
+// One row of benchmark output
+struct BenchResult {
+    string container;
+    int size;
+    string pattern;
+    string operation;
+    long long ops;
+    double nsPerOp;
+    double allocsPerOp;
+    double opsPerSec;
+};
+
+// Print values in the same layout as LinkedList::display
+template <typename It>
+void displaySequence(ostream& os, It first, It last, int count) {
+    os << "Linked List: ";
+    for (; first != last; ++first) {
+        os << *first << " -> ";
+    }
+    os << "NULL\nSize: " << count << " nodes\n";
+}
+
+// The containers under test, behind one interface
+template <typename List>
+class LinkedListBench {
+private:
+    List list;
+    
+public:
+    void pushBack(int value) { list.insertAtEnd(value); }
+    void insertAt(int position, int value) { list.insertAtMiddle(value, position); }
+    void eraseAt(int position) { list.deleteByPosition(position); }
+    void eraseValue(int value) { list.deleteByValue(value); }
+    void display(ostream& os) { list.display(os); }
+    void clear() { list.clear(); }
+};
+
+class ForwardListBench {
+private:
+    forward_list<int> items;
+    forward_list<int>::iterator last = items.before_begin();  // For O(1) appends
+    int count = 0;
+    
+    // Unlink the node after prev, keeping `last` valid
+    void eraseAfter(forward_list<int>::iterator prev) {
+        if (next(prev) == last) {
+            last = prev;
+        }
+        items.erase_after(prev);
+        count--;
+    }
+    
+public:
+    void pushBack(int value) {
+        last = items.insert_after(last, value);
+        count++;
+    }
+    
+    void insertAt(int position, int value) {
+        auto prev = next(items.before_begin(), position);
+        auto node = items.insert_after(prev, value);
+        if (prev == last) {
+            last = node;
+        }
+        count++;
+    }
+    
+    void eraseAt(int position) {
+        eraseAfter(next(items.before_begin(), position));
+    }
+    
+    void eraseValue(int value) {
+        for (auto prev = items.before_begin(); next(prev) != items.end(); ++prev) {
+            if (*next(prev) == value) {
+                eraseAfter(prev);
+                return;
+            }
+        }
+    }
+    
+    void display(ostream& os) { displaySequence(os, items.begin(), items.end(), count); }
+    
+    void clear() {
+        items.clear();
+        last = items.before_begin();
+        count = 0;
+    }
+};
+
+class ListBench {
+private:
+    list<int> items;
+    
+    // Walk from whichever end is closer
+    list<int>::iterator at(int position) {
+        int size = static_cast<int>(items.size());
+        if (position <= size / 2) {
+            return next(items.begin(), position);
+        }
+        return prev(items.end(), size - position);
+    }
+    
+public:
+    void pushBack(int value) { items.push_back(value); }
+    void insertAt(int position, int value) { items.insert(at(position), value); }
+    void eraseAt(int position) { items.erase(at(position)); }
+    void eraseValue(int value) { items.erase(find(items.begin(), items.end(), value)); }
+    void display(ostream& os) { displaySequence(os, items.begin(), items.end(), static_cast<int>(items.size())); }
+    void clear() { items.clear(); }
+};
+
+class VectorBench {
+private:
+    vector<int> items;
+    
+public:
+    void pushBack(int value) { items.push_back(value); }
+    void insertAt(int position, int value) { items.insert(items.begin() + position, value); }
+    void eraseAt(int position) { items.erase(items.begin() + position); }
+    void eraseValue(int value) { items.erase(find(items.begin(), items.end(), value)); }
+    void display(ostream& os) { displaySequence(os, items.begin(), items.end(), static_cast<int>(items.size())); }
+    void clear() { items.clear(); }
+};
+
+// Accumulates time and allocations over many timed batches
+class BenchTimer {
+private:
+    double nanos = 0;
+    long long allocations = 0;
+    long long ops = 0;
+    
+public:
+    template <typename Work>
+    void time(long long batchOps, Work work) {
+        long long allocsBefore = heapAllocations;
+        auto start = chrono::steady_clock::now();
+        work();
+        nanos += chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        allocations += heapAllocations - allocsBefore;
+        ops += batchOps;
+    }
+    
+    BenchResult result(const string& container, int size, const string& pattern, const string& operation) const {
+        double perOp = ops == 0 ? 0.0 : nanos / ops;
+        return {container, size, pattern, operation, ops, perOp,
+                ops == 0 ? 0.0 : static_cast<double>(allocations) / ops,
+                perOp == 0 ? 0.0 : 1e9 / perOp};
+    }
+};
+
+// Run every operation on one container at one size and access pattern.
+// Batches of inserts are undone by batches of deletes (and deleted values
+// are appended back untimed) so the list stays close to `size` throughout.
+template <typename Container>
+void benchmarkContainer(const string& name, int size, AccessPattern pattern, bool timeAppend,
+                        vector<BenchResult>& results) {
+    const string patternLabel = patternName(pattern);
+    mt19937 rng(size * 31 + static_cast<int>(pattern));
+    
+    // Enough operations for stable timings without O(n) ops running forever
+    long long targetOps = max(20LL, min(100000LL, 200000000LL / size));
+    int batch = static_cast<int>(min<long long>({static_cast<long long>(size), 1000LL, targetOps}));
+    
+    // Small lists are built several times so the append timing is stable
+    Container container;
+    BenchTimer append;
+    int builds = max(1, 100000 / size);
+    for (int round = 0; round < builds; round++) {
+        if (round > 0) {
+            container.clear();
+        }
+        append.time(size, [&] {
+            for (int i = 0; i < size; i++) {
+                container.pushBack(i);
+            }
+        });
+    }
+    if (timeAppend) {
+        results.push_back(append.result(name, size, "sequential", "insertAtEnd"));
+    }
+    
+    // deleteByValue: plan the targets on a mirror so the timed loop only
+    // deletes (each deleted batch is appended back afterwards)
+    vector<int> mirror(size);
+    for (int i = 0; i < size; i++) {
+        mirror[i] = i;
+    }
+    vector<int> targets;
+    for (long long done = 0; done < targetOps; done += batch) {
+        for (int i = 0; i < batch; i++) {
+            int position = pickPosition(pattern, static_cast<int>(mirror.size()), rng);
+            targets.push_back(mirror[position]);
+            mirror.erase(mirror.begin() + position);
+        }
+        mirror.insert(mirror.end(), targets.end() - batch, targets.end());
+    }
+    BenchTimer byValue;
+    for (size_t start = 0; start < targets.size(); start += batch) {
+        byValue.time(batch, [&] {
+            for (int i = 0; i < batch; i++) {
+                container.eraseValue(targets[start + i]);
+            }
+        });
+        for (int i = 0; i < batch; i++) {
+            container.pushBack(targets[start + i]);
+        }
+    }
+    
+    // insertAtMiddle / deleteByPosition in alternating batches
+    BenchTimer inserts;
+    BenchTimer erases;
+    vector<int> positions(batch);
+    for (long long done = 0; done < targetOps; done += batch) {
+        for (int i = 0; i < batch; i++) {
+            positions[i] = pickPosition(pattern, size + i + 1, rng);
+        }
+        inserts.time(batch, [&] {
+            for (int i = 0; i < batch; i++) {
+                container.insertAt(positions[i], -1 - i);
+            }
+        });
+        for (int i = 0; i < batch; i++) {
+            positions[i] = pickPosition(pattern, size + batch - i, rng);
+        }
+        erases.time(batch, [&] {
+            for (int i = 0; i < batch; i++) {
+                container.eraseAt(positions[i]);
+            }
+        });
+    }
+    results.push_back(inserts.result(name, size, patternLabel, "insertAtMiddle"));
+    results.push_back(erases.result(name, size, patternLabel, "deleteByPosition"));
+    results.push_back(byValue.result(name, size, patternLabel, "deleteByValue"));
+    
+    // display and clear don't depend on the pattern; time them once
+    if (timeAppend) {
+        DiscardBuffer discard;
+        ostream sinkStream(&discard);
+        int displays = static_cast<int>(max(1LL, min(10000LL, 20000000LL / size)));
+        BenchTimer show;
+        show.time(displays, [&] {
+            for (int i = 0; i < displays; i++) {
+                container.display(sinkStream);
+            }
+        });
+        results.push_back(show.result(name, size, "full", "display"));
+        
+        int clears = static_cast<int>(max(1LL, min(1000LL, 10000000LL / size)));
+        BenchTimer wipe;
+        for (int round = 0; round < clears; round++) {
+            if (round > 0) {
+                for (int i = 0; i < size; i++) {
+                    container.pushBack(i);
+                }
+            }
+            wipe.time(1, [&] { container.clear(); });
+        }
+        results.push_back(wipe.result(name, size, "full", "clear"));
+    }
+}
+
+void writeBenchCsv(const string& path, const vector<BenchResult>& results) {
+    ofstream file(path);
+    file << "container,size,pattern,operation,ops,ns_per_op,allocs_per_op,ops_per_sec\n";
+    for (const BenchResult& r : results) {
+        file << r.container << "," << r.size << "," << r.pattern << "," << r.operation << ","
+             << r.ops << "," << r.nsPerOp << "," << r.allocsPerOp << "," << r.opsPerSec << "\n";
+    }
+    if (!file) {
+        throw runtime_error("Failed writing " + path + "!");
+    }
+}
+
+void writeBenchJson(const string& path, const vector<BenchResult>& results) {
+    ofstream file(path);
+    file << "[\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        file << "  {\"container\": \"" << r.container << "\", \"size\": " << r.size
+             << ", \"pattern\": \"" << r.pattern << "\", \"operation\": \"" << r.operation
+             << "\", \"ops\": " << r.ops << ", \"ns_per_op\": " << r.nsPerOp
+             << ", \"allocs_per_op\": " << r.allocsPerOp << ", \"ops_per_sec\": " << r.opsPerSec
+             << (i + 1 < results.size() ? "},\n" : "}\n");
+    }
+    file << "]\n";
+    if (!file) {
+        throw runtime_error("Failed writing " + path + "!");
+    }
+}
+
+// Sweep sizes 10, 100, ... up to maxSize over every container and pattern,
+// print a table and optionally save CSV and JSON for comparing builds
+void runBenchmarkSuite(int maxSize, const string& csvPath, const string& jsonPath) {
+    vector<int> sizes;
+    for (long long size = 10; size <= maxSize; size *= 10) {
+        sizes.push_back(static_cast<int>(size));
+    }
+    if (sizes.empty() || sizes.back() != maxSize) {
+        sizes.push_back(maxSize);
+    }
+    
+    const AccessPattern patterns[] = {AccessPattern::HeadHeavy, AccessPattern::TailHeavy,
+                                      AccessPattern::Uniform, AccessPattern::Skewed};
+    vector<BenchResult> results;
+    
+    output << "\nLinkedList benchmark (sizes 10 to " << maxSize << ")\n";
+    output << left << setw(18) << "container" << right << setw(10) << "size" << "  "
+           << left << setw(11) << "pattern" << setw(17) << "operation" << right
+           << setw(12) << "ns/op" << setw(12) << "allocs/op" << setw(14) << "ops/sec" << '\n';
+    
+    for (int size : sizes) {
+        size_t first = results.size();
+        for (AccessPattern pattern : patterns) {
+            bool once = (pattern == patterns[0]);
+            benchmarkContainer<LinkedListBench<QuietList<int>>>("LinkedList", size, pattern, once, results);
+            benchmarkContainer<LinkedListBench<LinkedList<int, allocator<int>, HeapNodeAllocator, NullSink>>>(
+                "LinkedList(heap)", size, pattern, once, results);
+            benchmarkContainer<ForwardListBench>("forward_list", size, pattern, once, results);
+            benchmarkContainer<ListBench>("list", size, pattern, once, results);
+            benchmarkContainer<VectorBench>("vector", size, pattern, once, results);
+        }
+        
+        for (size_t i = first; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            output << left << setw(18) << r.container << right << setw(10) << r.size << "  "
+                   << left << setw(11) << r.pattern << setw(17) << r.operation << right
+                   << fixed << setprecision(1) << setw(12) << r.nsPerOp
+                   << setprecision(3) << setw(12) << r.allocsPerOp
+                   << setprecision(0) << setw(14) << r.opsPerSec << '\n';
+            output << defaultfloat << setprecision(6);
+        }
+        output.flush();
+    }
+    
+    if (!csvPath.empty()) {
+        writeBenchCsv(csvPath, results);
+        output << "Wrote " << csvPath << '\n';
+    }
+    if (!jsonPath.empty()) {
+        writeBenchJson(jsonPath, results);
+        output << "Wrote " << jsonPath << '\n';
+    }
+    output.flush();
+}
+
+// ============================================================================
+// WORKLOAD TRACES
+// ============================================================================
+
+// Operations a trace can record, one per LinkedList<int> call
+enum class TraceOp : uint8_t {
+    InsertAtBeginning,
+    InsertAtEnd,
+    InsertAtMiddle,
+    DeleteByPosition,
+    DeleteByValue,
+    Display,
+    Clear,
+    Count  // Number of operations
+};
+
+constexpr int traceOpCount = static_cast<int>(TraceOp::Count);
+
+const char* traceOpName(TraceOp op) {
+    static const char* const names[] = {
+        "insertAtBeginning", "insertAtEnd", "insertAtMiddle", "deleteByPosition",
+        "deleteByValue", "display", "clear"};
+    return names[static_cast<int>(op)];
+}
+
+// One decoded operation; arguments the op does not take are ignored
+struct TraceRecord {
+    TraceOp op;
+    int value;     // insertAt*, deleteByValue
+    int position;  // insertAtMiddle, deleteByPosition
+};
+
+inline bool traceOpHasValue(TraceOp op) {
+    return op == TraceOp::InsertAtBeginning || op == TraceOp::InsertAtEnd
+        || op == TraceOp::InsertAtMiddle || op == TraceOp::DeleteByValue;
+}
+
+inline bool traceOpHasPosition(TraceOp op) {
+    return op == TraceOp::InsertAtMiddle || op == TraceOp::DeleteByPosition;
+}
+
+// On-disk layout: this header followed by `payloadBytes` of records. Each
+// record is an op byte followed by its arguments as LEB128 varints (values
+// zig-zag encoded so small negatives stay short), so a typical record takes
+// two to four bytes and a billion operations fit in a few gigabytes.
+struct TraceHeader {
+    char magic[8];          // "SLLTRAC" and a terminating zero
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t records;       // Number of records that follow
+    uint64_t payloadBytes;  // Size of the records in bytes
+    uint64_t checksum;      // SnapshotChecksum of the record bytes
+};
+
+static_assert(sizeof(TraceHeader) == 40, "Trace header must stay 40 bytes");
+
+constexpr char traceMagic[8] = "SLLTRAC";
+constexpr uint32_t traceVersion = 1;
+
+// Largest encoded record: op byte plus two five-byte varints
+constexpr size_t maxTraceRecordBytes = 11;
+
+// Records are streamed through buffers of this size when writing or reading
+constexpr size_t traceChunkBytes = 1 << 22;
+
+// Encode `record` at `out` and return the number of bytes written
+inline size_t encodeTraceRecord(const TraceRecord& record, unsigned char* out) {
+    unsigned char* start = out;
+    auto put = [&out](uint32_t bits) {
+        while (bits >= 0x80) {
+            *out++ = static_cast<unsigned char>(bits | 0x80);
+            bits >>= 7;
+        }
+        *out++ = static_cast<unsigned char>(bits);
+    };
+    
+    *out++ = static_cast<unsigned char>(record.op);
+    if (traceOpHasValue(record.op)) {
+        uint32_t bits = static_cast<uint32_t>(record.value);
+        put((bits << 1) ^ (0u - (bits >> 31)));
+    }
+    if (traceOpHasPosition(record.op)) {
+        put(static_cast<uint32_t>(record.position));
+    }
+    return static_cast<size_t>(out - start);
+}
+
+// Decode the record starting at `in` and advance past it. Returns false
+// (leaving `in` alone) if the record runs past `end`; throws if the bytes
+// cannot be a record.
+inline bool decodeTraceRecord(const unsigned char*& in, const unsigned char* end,
+                              TraceRecord& record, const string& path) {
+    const unsigned char* p = in;
+    auto get = [&](uint32_t& bits) {
+        bits = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            if (p == end) {
+                return false;
+            }
+            unsigned char byte = *p++;
+            bits |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return true;
+            }
+        }
+        throw runtime_error("Trace " + path + " holds an over-long varint!");
+    };
+    
+    if (p == end) {
+        return false;
+    }
+    if (*p >= traceOpCount) {
+        throw runtime_error("Trace " + path + " holds unknown operation " + to_string(*p) + "!");
+    }
+    record.op = static_cast<TraceOp>(*p++);
+    
+    uint32_t bits;
+    if (traceOpHasValue(record.op)) {
+        if (!get(bits)) {
+            return false;
+        }
+        record.value = static_cast<int>((bits >> 1) ^ (0u - (bits & 1)));
+    }
+    if (traceOpHasPosition(record.op)) {
+        if (!get(bits)) {
+            return false;
+        }
+        record.position = static_cast<int>(bits);
+    }
+    in = p;
+    return true;
+}
+
+// Throw if `header` does not describe a workload trace
+inline void checkTraceHeader(const TraceHeader& header, const string& path) {
+    if (memcmp(header.magic, traceMagic, sizeof(traceMagic)) != 0) {
+        throw runtime_error("File " + path + " is not a workload trace!");
+    }
+    if (header.version != traceVersion) {
+        throw runtime_error("Trace " + path + " has unsupported version " + to_string(header.version) + "!");
+    }
+}
+
+// Throw unless a full pass over the payload matched the header
+inline void checkTraceEnd(const TraceHeader& header, uint64_t records, uint64_t bytes,
+                          const SnapshotChecksum& checksum, const string& path) {
+    if (records != header.records || bytes != header.payloadBytes) {
+        throw runtime_error("Trace " + path + " is truncated!");
+    }
+    if (checksum.value() != header.checksum) {
+        throw runtime_error("Trace " + path + " failed its checksum!");
+    }
+}
+
+// Writes records through a fixed-size chunk buffer, so traces of any length
+// can be produced. As with SnapshotWriter the header is only completed by
+// close(), so a half-written trace never replays.
+class TraceWriter {
+private:
+    FILE* file;
+    string path;
+    vector<unsigned char> chunk;
+    size_t used;  // Bytes filled in chunk
+    uint64_t records;
+    uint64_t bytes;
+    SnapshotChecksum checksum;
+    
+    void flushChunk() {
+        if (used > 0 && fwrite(chunk.data(), 1, used, file) != used) {
+            throw runtime_error("Failed writing trace " + path + "!");
+        }
+        checksum.update(chunk.data(), used);
+        used = 0;
+    }
+    
+public:
+    explicit TraceWriter(const string& target)
+        : file(fopen(target.c_str(), "wb")), path(target), chunk(traceChunkBytes),
+          used(0), records(0), bytes(0) {
+        if (file == nullptr) {
+            throw runtime_error("Cannot open trace file " + path + " for writing!");
+        }
+        TraceHeader placeholder = {};
+        if (fwrite(&placeholder, sizeof(placeholder), 1, file) != 1) {
+            fclose(file);
+            throw runtime_error("Failed writing trace " + path + "!");
+        }
+    }
+    
+    ~TraceWriter() {
+        if (file != nullptr) {
+            fclose(file);
+        }
+    }
+    
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+    
+    void write(const TraceRecord& record) {
+        if (chunk.size() - used < maxTraceRecordBytes) {
+            flushChunk();
+        }
+        size_t n = encodeTraceRecord(record, chunk.data() + used);
+        used += n;
+        bytes += n;
+        records++;
+    }
+    
+    uint64_t count() const {
+        return records;
+    }
+    
+    // Flush the last chunk, fill in the header and close the file
+    void close() {
+        flushChunk();
+        
+        TraceHeader header = {};
+        memcpy(header.magic, traceMagic, sizeof(traceMagic));
+        header.version = traceVersion;
+        header.records = records;
+        header.payloadBytes = bytes;
+        header.checksum = checksum.value();
+        
+        bool ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+        ok = (fclose(file) == 0) && ok;
+        file = nullptr;
+        if (!ok) {
+            throw runtime_error("Failed writing trace " + path + "!");
+        }
+    }
+};
+
+// Reads a trace in large chunks with plain buffered I/O. A record cut in
+// half by the end of a chunk is carried over to the front of the next one.
+class TraceReader {
+private:
+    FILE* file;
+    string path;
+    TraceHeader header;
+    
+public:
+    explicit TraceReader(const string& source) : file(fopen(source.c_str(), "rb")), path(source) {
+        if (file == nullptr) {
+            throw runtime_error("Cannot open trace file " + path + "!");
+        }
+        if (fread(&header, sizeof(header), 1, file) != 1) {
+            fclose(file);
+            throw runtime_error("File " + path + " is not a workload trace!");
+        }
+        try {
+            checkTraceHeader(header, path);
+        } catch (...) {
+            fclose(file);
+            throw;
+        }
+    }
+    
+    ~TraceReader() {
+        fclose(file);
+    }
+    
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+    
+    uint64_t count() const {
+        return header.records;
+    }
+    
+    uint64_t payloadBytes() const {
+        return header.payloadBytes;
+    }
+    
+    // Call visit(record) for each record in file order, then check the
+    // counts and checksum (throws if the file is truncated or corrupt)
+    template <typename Visitor>
+    void forEachRecord(Visitor visit) {
+        vector<unsigned char> buffer(traceChunkBytes);
+        SnapshotChecksum checksum;
+        uint64_t records = 0;
+        uint64_t consumed = 0;
+        uint64_t unread = header.payloadBytes;
+        size_t carried = 0;  // Bytes of a partial record at the front of buffer
+        
+        while (unread > 0) {
+            size_t want = static_cast<size_t>(min<uint64_t>(unread, buffer.size() - carried));
+            size_t got = fread(buffer.data() + carried, 1, want, file);
+            if (got == 0) {
+                break;
+            }
+            unread -= got;
+            
+            const unsigned char* in = buffer.data();
+            const unsigned char* end = in + carried + got;
+            TraceRecord record;
+            while (decodeTraceRecord(in, end, record, path)) {
+                visit(record);
+                records++;
+            }
+            
+            size_t used = static_cast<size_t>(in - buffer.data());
+            checksum.update(buffer.data(), used);
+            consumed += used;
+            carried = static_cast<size_t>(end - in);
+            memmove(buffer.data(), in, carried);
+        }
+        
+        checkTraceEnd(header, records, consumed, checksum, path);
+    }
+};
+
+#if SNAPSHOT_USE_MMAP
+// Maps a whole trace read-only and decodes straight out of the page cache.
+// Offers the same forEachRecord interface as TraceReader.
+class MappedTrace {
+private:
+    void* mapping;
+    size_t length;
+    string path;
+    TraceHeader header;
+    
+public:
+    explicit MappedTrace(const string& source) : mapping(MAP_FAILED), length(0), path(source) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw runtime_error("Cannot open trace file " + path + "!");
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(TraceHeader)) {
+            ::close(fd);
+            throw runtime_error("File " + path + " is not a workload trace!");
+        }
+        length = static_cast<size_t>(info.st_size);
+        mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            throw runtime_error("Cannot map trace file " + path + "!");
+        }
+        
+        memcpy(&header, mapping, sizeof(header));
+        try {
+            checkTraceHeader(header, path);
+            if (length - sizeof(header) < header.payloadBytes) {
+                throw runtime_error("Trace " + path + " is truncated!");
+            }
+        } catch (...) {
+            munmap(mapping, length);
+            throw;
+        }
+        
+        madvise(mapping, length, MADV_SEQUENTIAL);
+    }
+    
+    ~MappedTrace() {
+        munmap(mapping, length);
+    }
+    
+    MappedTrace(const MappedTrace&) = delete;
+    MappedTrace& operator=(const MappedTrace&) = delete;
+    
+    uint64_t count() const {
+        return header.records;
+    }
+    
+    uint64_t payloadBytes() const {
+        return header.payloadBytes;
+    }
+    
+    // Call visit(record) for each record in file order, then check the
+    // counts and checksum (throws if the file is corrupt)
+    template <typename Visitor>
+    void forEachRecord(Visitor visit) {
+        const unsigned char* payload = static_cast<const unsigned char*>(mapping) + sizeof(header);
+        const unsigned char* end = payload + header.payloadBytes;
+        const unsigned char* in = payload;
+        SnapshotChecksum checksum;
+        uint64_t records = 0;
+        
+        // Decode a chunk's worth at a time so the checksum pass reads bytes
+        // that are still in cache
+        while (in < end) {
+            const unsigned char* chunkStart = in;
+            const unsigned char* chunkEnd = in + min<size_t>(traceChunkBytes, static_cast<size_t>(end - in));
+            TraceRecord record;
+            while (in < chunkEnd && decodeTraceRecord(in, end, record, path)) {
+                visit(record);
+                records++;
+            }
+            checksum.update(chunkStart, static_cast<size_t>(in - chunkStart));
+            if (in < chunkEnd) {
+                break;  // Last record runs past the payload
+            }
+        }
+        
+        checkTraceEnd(header, records, static_cast<uint64_t>(in - payload), checksum, path);
+    }
+};
+#endif
+
+// Shape of a synthetic trace
+struct TraceMix {
+    // Relative weight of each TraceOp
+    double weights[traceOpCount] = {20, 20, 10, 30, 20, 0.01, 0.001};
+    // Where positional arguments and deleted values are drawn from
+    AccessPattern pattern = AccessPattern::Uniform;
+    // The list is filled to this size first, then inserts past twice the
+    // size turn into deletes and deletes below half of it into inserts
+    int targetSize = 10000;
+    // Inserted values are uniform in [0, valueRange); 0 means 2 * targetSize
+    int valueRange = 0;
+};
+
+AccessPattern parseAccessPattern(const string& name) {
+    for (AccessPattern pattern : {AccessPattern::HeadHeavy, AccessPattern::TailHeavy,
+                                  AccessPattern::Uniform, AccessPattern::Skewed}) {
+        if (name == patternName(pattern)) {
+            return pattern;
+        }
+    }
+    throw runtime_error("Unknown access pattern " + name + "!");
+}
+
+// Write a trace of `records` operations following `mix`. Every operation is
+// also applied to a shadow list, so positions are always in range and
+// deleteByValue always names a value that is present: replaying the trace
+// exercises the list rather than its error paths.
+void generateTrace(const string& path, uint64_t records, const TraceMix& mix, unsigned seed) {
+    if (mix.targetSize < 1) {
+        throw runtime_error("Trace target size must be at least 1!");
+    }
+    mt19937 rng(seed);
+    discrete_distribution<int> pickOp(begin(mix.weights), end(mix.weights));
+    uniform_int_distribution<int> pickValue(0, (mix.valueRange > 0 ? mix.valueRange : 2 * mix.targetSize) - 1);
+    
+    QuietList<int> shadow;
+    TraceWriter writer(path);
+    
+    for (uint64_t i = 0; i < records; i++) {
+        int size = shadow.getSize();
+        TraceRecord record = {};
+        record.op = (i < static_cast<uint64_t>(mix.targetSize)) ? TraceOp::InsertAtEnd
+                                                                : static_cast<TraceOp>(pickOp(rng));
+        
+        bool inserting = traceOpHasValue(record.op) && record.op != TraceOp::DeleteByValue;
+        bool deleting = record.op == TraceOp::DeleteByPosition || record.op == TraceOp::DeleteByValue;
+        if (inserting && size >= 2 * mix.targetSize) {
+            record.op = TraceOp::DeleteByPosition;
+        } else if (deleting && size <= mix.targetSize / 2) {
+            record.op = TraceOp::InsertAtMiddle;
+        }
+        
+        switch (record.op) {
+            case TraceOp::InsertAtBeginning:
+                record.value = pickValue(rng);
+                shadow.insertAtBeginning(record.value);
+                break;
+            case TraceOp::InsertAtEnd:
+                record.value = pickValue(rng);
+                shadow.insertAtEnd(record.value);
+                break;
+            case TraceOp::InsertAtMiddle:
+                record.value = pickValue(rng);
+                record.position = pickPosition(mix.pattern, size + 1, rng);
+                shadow.insertAtMiddle(record.value, record.position);
+                break;
+            case TraceOp::DeleteByPosition:
+                record.position = pickPosition(mix.pattern, size, rng);
+                shadow.deleteByPosition(record.position);
+                break;
+            case TraceOp::DeleteByValue:
+                record.value = shadow.at(pickPosition(mix.pattern, size, rng));
+                shadow.deleteByValue(record.value);
+                break;
+            case TraceOp::Display:
+                break;
+            case TraceOp::Clear:
+                shadow.clear();
+                break;
+            case TraceOp::Count:
+                break;
+        }
+        writer.write(record);
+    }
+    writer.close();
+}
+
+// Per-operation results of a replay
+struct TraceOpStats {
+    uint64_t count = 0;
+    uint64_t errors = 0;  // Calls that missed (status other than Ok)
+    double nanos = 0;
+    LatencyHistogram latency;
+};
+
+struct ReplayReport {
+    uint64_t records = 0;
+    uint64_t payloadBytes = 0;
+    double seconds = 0;
+    int finalSize = 0;
+    TraceOpStats ops[traceOpCount];
+};
+
+// Apply every record from `source` to `list`, timing each one. Only one
+// clock read is taken per record, so each latency covers decoding the
+// record as well as the call (a few nanoseconds). display() writes into a
+// discarding stream. Misses go through the try* calls, so they are counted
+// as errors without paying for an exception.
+template <typename Source>
+void replayTrace(Source& source, QuietList<int>& list, ReplayReport& report) {
+    DiscardBuffer discard;
+    ostream sink(&discard);
+    
+    auto start = chrono::steady_clock::now();
+    auto last = start;
+    source.forEachRecord([&](const TraceRecord& record) {
+        TraceOpStats& stats = report.ops[static_cast<int>(record.op)];
+        ListStatus status = ListStatus::Ok;
+        switch (record.op) {
+            case TraceOp::InsertAtBeginning: list.insertAtBeginning(record.value); break;
+            case TraceOp::InsertAtEnd:       list.insertAtEnd(record.value); break;
+            case TraceOp::InsertAtMiddle:    status = list.tryInsertAtMiddle(record.value, record.position); break;
+            case TraceOp::DeleteByPosition:  status = list.tryDeleteByPosition(record.position); break;
+            case TraceOp::DeleteByValue:     status = list.tryDeleteByValue(record.value); break;
+            case TraceOp::Display:           list.display(sink); break;
+            case TraceOp::Clear:             list.clear(); break;
+            case TraceOp::Count:             break;
+        }
+        stats.errors += (status != ListStatus::Ok);
+        auto now = chrono::steady_clock::now();
+        uint64_t nanos = static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(now - last).count());
+        last = now;
+        stats.count++;
+        stats.nanos += static_cast<double>(nanos);
+        stats.latency.record(nanos);
+    });
+    
+    report.seconds = chrono::duration<double>(last - start).count();
+    report.records = source.count();
+    report.payloadBytes = source.payloadBytes();
+    report.finalSize = list.getSize();
+}
+
+// Replay the trace at `path` into a fresh list with output disabled.
+// Memory-maps the file unless `buffered` is set (or mmap is unavailable).
+ReplayReport replayTraceFile(const string& path, bool buffered, bool valueIndex) {
+    ReplayReport report;
+    QuietList<int> list;
+    if (valueIndex) {
+        list.enableValueIndex();
+    }
+#if SNAPSHOT_USE_MMAP
+    if (!buffered) {
+        MappedTrace source(path);
+        replayTrace(source, list, report);
+        return report;
+    }
+#endif
+    TraceReader source(path);
+    replayTrace(source, list, report);
+    return report;
+}
+
+void printReplayReport(const ReplayReport& report) {
+    output << report.records << " records (" << fixed << setprecision(1)
+           << report.payloadBytes / 1e6 << " MB) in " << setprecision(3) << report.seconds << " s - "
+           << setprecision(0) << (report.seconds > 0 ? report.records / report.seconds : 0.0)
+           << " ops/sec, " << setprecision(1)
+           << (report.seconds > 0 ? report.payloadBytes / 1e6 / report.seconds : 0.0)
+           << " MB/s, final size " << report.finalSize << '\n';
+    output << left << setw(18) << "operation" << right << setw(12) << "count" << setw(9) << "errors"
+           << setw(14) << "ops/sec" << setw(10) << "p50 ns" << setw(10) << "p99 ns"
+           << setw(11) << "p99.9 ns" << setw(12) << "max ns" << '\n';
+    for (int op = 0; op < traceOpCount; op++) {
+        const TraceOpStats& stats = report.ops[op];
+        if (stats.count == 0) {
+            continue;
+        }
+        output << left << setw(18) << traceOpName(static_cast<TraceOp>(op)) << right
+               << setw(12) << stats.count << setw(9) << stats.errors << setprecision(0)
+               << setw(14) << (stats.nanos > 0 ? stats.count * 1e9 / stats.nanos : 0.0)
+               << setw(10) << stats.latency.percentile(0.5) << setw(10) << stats.latency.percentile(0.99)
+               << setw(11) << stats.latency.percentile(0.999) << setw(12) << stats.latency.maximum() << '\n';
+    }
+    output << defaultfloat << setprecision(6);
+}
+
+// Helper function to print section headers
+void printSection(const string& title) {
+    output << "\n" << string(50, '=') << '\n';
+    output << title << '\n';
+    output << string(50, '=') << '\n';
+}
+
+// Test Case 1: Basic operations
+void testCase1() {
+    printSection("TEST CASE 1: Basic Insert and Delete Operations");
+    
+    LinkedList list;
+    
+    output << "\n||====> Inserting elements <====||" << '\n';
+    list.insertAtEnd(10);
+    list.insertAtEnd(20);
+    list.insertAtEnd(30);
+    list.display();
+    
+    output << "\n||====> Insert at beginning <====||" << '\n';
+    list.insertAtBeginning(5);
+    list.display();
+    
+    output << "\n||====> Insert at middle (position 2) <====||" << '\n';
+    list.insertAtMiddle(15, 2);
+    list.display();
+    
+    output << "\n||====> Delete by position (position 3) <====||" << '\n';
+    list.deleteByPosition(3);
+    list.display();
+    
+    output << "\n||====> Delete by value (value 15) <====||" << '\n';
+    list.deleteByValue(15);
+    list.display();
+}
+
+// Test Case 2: Edge cases and error handling
+void testCase2() {
+    printSection("TEST CASE 2: Edge Cases and Error Handling");
+    
+    LinkedList list;
+    
+    output << "\n||====> Attempting to delete from empty list <====||" << '\n';
+    try {
+        list.deleteByPosition(0);
+    } catch (const exception& e) {
+        output << "X Error caught: " << e.what() << '\n';
+    }
+    
+    output << "\n||====> Insert into empty list <====||" << '\n';
+    list.insertAtBeginning(100);
+    list.display();
+    
+    output << "\n||====> Attempting invalid position insertion <====||" << '\n';
+    try {
+        list.insertAtMiddle(200, 5);
+    } catch (const exception& e) {
+        output << "X Error caught: " << e.what() << '\n';
+    }
+    
+    output << "\n||====> Valid insertion at position 1 <====||" << '\n';
+    list.insertAtMiddle(150, 1);
+    list.display();
+    
+    output << "\n||====> Attempting to delete non-existent value <====||" << '\n';
+    try {
+        list.deleteByValue(999);
+    } catch (const exception& e) {
+        output << "X Error caught: " << e.what() << '\n';
+    }
+    
+    output << "\n====> Delete all elements <====" << '\n';
+    list.deleteByPosition(0);
+    list.deleteByPosition(0);
+    list.display();
+}
+
+// Test Case 3: Large list operations
+void testCase3() {
+    printSection("TEST CASE 3: Operations on Larger List");
+    
+    LinkedList list;
+    
+    output << "\n||====> Building list with values 2, 4, 6, 8, 10, 12 <====||" << '\n';
+    for (int i = 2; i <= 12; i += 2) {
+        list.insertAtEnd(i);
+    }
+    list.display();
+    
+    output << "\n||====> Insert 1 at beginning <====||" << '\n';
+    list.insertAtBeginning(1);
+    list.display();
+    
+    output << "\n||====> Insert 7 at position 4 <====||" << '\n';
+    list.insertAtMiddle(7, 4);
+    list.display();
+    
+    output << "\n||====> Insert 14 at end <====||" << '\n';
+    list.insertAtEnd(14);
+    list.display();
+    
+    output << "\n||====> Delete values 1, 7, and 14 <====||" << '\n';
+    list.deleteByValue(1);
+    list.deleteByValue(7);
+    list.deleteByValue(14);
+    list.display();
+    
+    output << "\n||====> Delete positions 0 and 2 <====||" << '\n';
+    list.deleteByPosition(0);
+    list.deleteByPosition(2);
+    list.display();
+}
+
+// Test Case 4: Bulk append and assign
+void testCase4() {
+    printSection("TEST CASE 4: Bulk appendRange and assign");
+    
+    LinkedList list;
+    
+    output << "\n||====> appendRange with values 1..5 <====||" << '\n';
+    vector<int> batch = {1, 2, 3, 4, 5};
+    list.appendRange(batch);
+    list.display();
+    
+    output << "\n||====> Insert 6 at end (uses tail pointer) <====||" << '\n';
+    list.insertAtEnd(6);
+    list.display();
+    
+    output << "\n||====> Delete last node, then append again <====||" << '\n';
+    list.deleteByPosition(list.getSize() - 1);
+    list.insertAtEnd(7);
+    list.display();
+    
+    output << "\n||====> appendRange with an empty batch <====||" << '\n';
+    vector<int> empty;
+    list.appendRange(empty);
+    list.display();
+    
+    output << "\n||====> assign values 100, 200, 300 <====||" << '\n';
+    int values[] = {100, 200, 300};
+    list.assign(begin(values), end(values));
+    list.display();
+    
+    output << "\n||====> Delete value 300, then insert 400 at end <====||" << '\n';
+    list.deleteByValue(300);
+    list.insertAtEnd(400);
+    list.display();
+}
+
+// Helper function to print node allocator statistics
+void printAllocatorStats(const AllocatorStats& stats) {
+    output << "Slabs: " << stats.slabCount
+         << ", slots: " << stats.slabCapacity
+         << ", live nodes: " << stats.liveNodes
+         << ", allocations: " << stats.allocations
+         << ", reused: " << stats.reused
+         << " (" << static_cast<int>(stats.reuseRate() * 100) << "%)" << '\n';
+}
+
+// Test Case 5: Slab allocator and free-list reuse
+void testCase5() {
+    printSection("TEST CASE 5: Slab Node Allocator");
+    
+    LinkedList list;
+    
+    output << "\n||====> Build 100 nodes with appendRange <====||" << '\n';
+    vector<int> values;
+    for (int i = 1; i <= 100; i++) {
+        values.push_back(i);
+    }
+    list.appendRange(values);
+    printAllocatorStats(list.allocatorStats());
+    
+    output << "\n||====> Churn: delete head then insert at end, 10 times <====||" << '\n';
+    for (int i = 0; i < 10; i++) {
+        list.deleteByPosition(0);
+        list.insertAtEnd(1000 + i);
+    }
+    output << "Size after churn: " << list.getSize() << '\n';
+    printAllocatorStats(list.allocatorStats());
+    
+    output << "\n||====> Clear releases whole slabs <====||" << '\n';
+    list.clear();
+    list.display();
+    printAllocatorStats(list.allocatorStats());
+    
+    output << "\n||====> Plain heap allocator plugged in <====||" << '\n';
+    LinkedList<int, allocator<int>, HeapNodeAllocator> heapList;
+    heapList.appendRange(values);
+    heapList.deleteByValue(50);
+    heapList.insertAtBeginning(0);
+    printAllocatorStats(heapList.allocatorStats());
+}
+
+// Test Case 6: Unrolled list with chunked storage and SIMD search
+void testCase6() {
+    printSection("TEST CASE 6: Unrolled Linked List");
+    
+    UnrolledLinkedList list;
+    
+    output << "\n||====> appendRange with values 1..20 <====||" << '\n';
+    vector<int> values;
+    for (int i = 1; i <= 20; i++) {
+        values.push_back(i);
+    }
+    list.appendRange(values);
+    list.display();
+    
+    output << "\n||====> Insert 99 at position 5 (splits a full chunk) <====||" << '\n';
+    list.insertAtMiddle(99, 5);
+    list.display();
+    
+    output << "\n||====> Insert 0 at beginning and 21 at end <====||" << '\n';
+    list.insertAtBeginning(0);
+    list.insertAtEnd(21);
+    list.display();
+    
+    output << "\n||====> find and contains <====||" << '\n';
+    output << "find(99): " << list.find(99) << '\n';
+    output << "find(21): " << list.find(21) << '\n';
+    output << "contains(500): " << (list.contains(500) ? "yes" : "no") << '\n';
+    
+    output << "\n||====> Delete values 99, 21 and positions 0..5 <====||" << '\n';
+    list.deleteByValue(99);
+    list.deleteByValue(21);
+    for (int i = 0; i < 6; i++) {
+        list.deleteByPosition(0);
+    }
+    list.display();
+    
+    output << "\n||====> Attempting to delete non-existent value <====||" << '\n';
+    try {
+        list.deleteByValue(999);
+    } catch (const exception& e) {
+        output << "X Error caught: " << e.what() << '\n';
+    }
+    
+    output << "\n||====> Delete everything by value <====||" << '\n';
+    for (int i = 6; i <= 20; i++) {
+        list.deleteByValue(i);
+    }
     list.display();
 }
 
-// Test Case 3: Large list operations
-void testCase3() {
-    printSection("TEST CASE 3: Operations on Larger List");
+// Test Case 7: Pluggable event sinks
+void testCase7() {
+    printSection("TEST CASE 7: Event Sinks");
+    
+    output << "\n||====> Counting sink: 1000 appends and 990 head deletes <====||" << '\n';
+    LinkedList<int, allocator<int>, SlabNodeAllocator, CountingSink> counted;
+    for (int i = 0; i < 1000; i++) {
+        counted.insertAtEnd(i);
+    }
+    for (int i = 0; i < 990; i++) {
+        counted.deleteByPosition(0);
+    }
+    const CountingSink& counts = counted.eventSink();
+    output << "Inserted at end: " << counts.count(ListEvent::InsertedAtEnd)
+           << ", into empty: " << counts.count(ListEvent::InsertedIntoEmpty)
+           << ", deleted at position: " << counts.count(ListEvent::DeletedAtPosition)
+           << ", total: " << counts.total() << '\n';
+    counted.display();
+    
+    output << "\n||====> Null sink: silent operations <====||" << '\n';
+    QuietList<int> silent;
+    silent.insertAtEnd(1);
+    silent.insertAtBeginning(0);
+    silent.insertAtMiddle(5, 1);
+    silent.deleteByValue(0);
+    silent.display();
+    
+    output << "\n||====> Unrolled list with a counting sink <====||" << '\n';
+    UnrolledLinkedList<CountingSink> unrolled;
+    for (int i = 0; i < 40; i++) {
+        unrolled.insertAtMiddle(i, unrolled.getSize() / 2);
+    }
+    output << "Events recorded: " << unrolled.eventSink().total() << '\n';
+    unrolled.display();
+}
+
+// Test Case 8: Positional index for deep insertAtMiddle/deleteByPosition
+void testCase8() {
+    printSection("TEST CASE 8: Skip List Positional Index");
+    
+    QuietList<int> list;
+    
+    output << "\n||====> Build 1000 nodes (index not built yet) <====||" << '\n';
+    vector<int> values;
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(i * 10);
+    }
+    list.appendRange(values);
+    output << "Index built: " << (list.hasPositionIndex() ? "yes" : "no") << '\n';
+    
+    output << "\n||====> First positional call builds the index <====||" << '\n';
+    output << "at(500): " << list.at(500) << '\n';
+    output << "Index built: " << (list.hasPositionIndex() ? "yes" : "no") << '\n';
+    
+    output << "\n||====> Insert 7 at position 700, delete position 100 <====||" << '\n';
+    list.insertAtMiddle(7, 700);
+    list.deleteByPosition(100);
+    output << "at(699): " << list.at(699) << '\n';
+    output << "at(100): " << list.at(100) << '\n';
+    
+    output << "\n||====> Head and tail operations keep the index in sync <====||" << '\n';
+    list.insertAtBeginning(-1);
+    list.insertAtEnd(99999);
+    list.deleteByValue(5000);
+    output << "at(0): " << list.at(0) << ", at(500): " << list.at(500)
+           << ", at(" << list.getSize() - 1 << "): " << list.at(list.getSize() - 1) << '\n';
+
+    output << "\n||====> Mixed head, tail and middle edits against a vector <====||" << '\n';
+    vector<int> mirror;
+    for (int i = 0; i < list.getSize(); i++) {
+        mirror.push_back(list.at(i));
+    }
+    for (int i = 0; i < 3000; i++) {
+        int position = static_cast<int>((i * 7919u) % (mirror.size() + 1));
+        switch (i % 5) {
+            case 0:
+                list.insertAtEnd(i);
+                mirror.push_back(i);
+                break;
+            case 1:
+                list.insertAtBeginning(i);
+                mirror.insert(mirror.begin(), i);
+                break;
+            case 2:
+                list.deleteByPosition(list.getSize() - 1);
+                mirror.pop_back();
+                break;
+            case 3:
+                list.insertAtMiddle(i, position);
+                mirror.insert(mirror.begin() + position, i);
+                break;
+            default:
+                list.deleteByPosition(0);
+                mirror.erase(mirror.begin());
+                break;
+        }
+    }
+    bool inSync = list.getSize() == static_cast<int>(mirror.size());
+    for (int i = 0; inSync && i < list.getSize(); i++) {
+        inSync = list.at(i) == mirror[i];
+    }
+    output << "Every position matches: " << (inSync ? "yes" : "no") << '\n';
+
+    output << "\n||====> Small lists never build the index <====||" << '\n';
+    QuietList<int> small;
+    small.appendRange(vector<int>{1, 2, 3});
+    small.insertAtMiddle(9, 1);
+    output << "at(1): " << small.at(1) << ", index built: "
+           << (small.hasPositionIndex() ? "yes" : "no") << '\n';
+    
+    output << "\n||====> Attempting out-of-range at() <====||" << '\n';
+    try {
+        small.at(10);
+    } catch (const exception& e) {
+        output << "X Error caught: " << e.what() << '\n';
+    }
+}
+
+// Test Case 9: Value index for constant-time deleteByValue and lookups
+void testCase9() {
+    printSection("TEST CASE 9: Value Hash Index");
     
     LinkedList list;
+    list.appendRange(vector<int>{4, 8, 15, 16, 23, 42, 8});
+    list.enableValueIndex();
+    list.display();
     
-    cout << "\n||====> Building list with values 2, 4, 6, 8, 10, 12 <====||" << endl;
-    for (int i = 2; i <= 12; i += 2) {
-        list.insertAtEnd(i);
+    output << "\n||====> contains and count <====||" << '\n';
+    output << "contains(15): " << (list.contains(15) ? "yes" : "no")
+           << ", count(8): " << list.count(8)
+           << ", count(99): " << list.count(99) << '\n';
+    
+    output << "\n||====> Delete value 8 removes the first occurrence <====||" << '\n';
+    list.deleteByValue(8);
+    list.display();
+    output << "count(8): " << list.count(8) << '\n';
+    
+    output << "\n||====> Inserts keep the index in sync <====||" << '\n';
+    list.insertAtBeginning(42);
+    list.insertAtMiddle(15, 3);
+    list.deleteByValue(42);
+    list.deleteByValue(15);
+    list.display();
+    
+    output << "\n||====> Attempting to delete non-existent value <====||" << '\n';
+    try {
+        list.deleteByValue(999);
+    } catch (const exception& e) {
+        output << "X Error caught: " << e.what() << '\n';
+    }
+    
+    output << "\n||====> Mixed edits with duplicates against a vector <====||" << '\n';
+    QuietList<int> edited;
+    vector<int> mirror;
+    for (int i = 0; i < 2000; i++) {
+        mirror.push_back(i % 300);
+    }
+    edited.appendRange(mirror);
+    edited.enableValueIndex();
+    edited.at(1000);  // Build the positional index as well
+    for (int i = 0; i < 6000; i++) {
+        int value = static_cast<int>((i * 2654435761u) % 300);
+        int position = static_cast<int>((i * 7919u) % (mirror.size() + 1));
+        switch (i % 6) {
+            case 0:
+                edited.insertAtBeginning(value);
+                mirror.insert(mirror.begin(), value);
+                break;
+            case 1:
+                edited.insertAtEnd(value);
+                mirror.push_back(value);
+                break;
+            case 2:
+                edited.insertAtMiddle(value, position);
+                mirror.insert(mirror.begin() + position, value);
+                break;
+            case 3:
+                if (position < static_cast<int>(mirror.size())) {
+                    edited.deleteByPosition(position);
+                    mirror.erase(mirror.begin() + position);
+                }
+                break;
+            case 4:
+                edited.compactStep(50);
+                break;
+            default: {
+                auto found = find(mirror.begin(), mirror.end(), value);
+                if (found != mirror.end()) {
+                    edited.deleteByValue(value);
+                    mirror.erase(found);
+                }
+                break;
+            }
+        }
+    }
+    bool inSync = edited.getSize() == static_cast<int>(mirror.size());
+    for (int i = 0; inSync && i < edited.getSize(); i++) {
+        inSync = edited.at(i) == mirror[i];
+    }
+    for (int value = 0; inSync && value < 300; value++) {
+        inSync = edited.count(value) == static_cast<int>(std::count(mirror.begin(), mirror.end(), value));
+    }
+    output << "Positions and counts match: " << (inSync ? "yes" : "no")
+           << ", positional index kept: " << (edited.hasPositionIndex() ? "yes" : "no") << '\n';
+
+    output << "\n||====> Memory overhead <====||" << '\n';
+    output << "Index bytes per node: " << list.valueIndexBytesPerNode() << '\n';
+}
+
+// Payload type used to show values being built in place
+struct Reading {
+    string sensor;
+    double value;
+    
+    Reading(string name, double v) : sensor(std::move(name)), value(v) {}
+};
+
+ostream& operator<<(ostream& os, const Reading& reading) {
+    return os << reading.sensor << "=" << reading.value;
+}
+
+// Test Case 10: Generic element types, iterators and move semantics
+void testCase10() {
+    printSection("TEST CASE 10: Generic LinkedList<T>");
+    
+    output << "\n||====> LinkedList<string> <====||" << '\n';
+    LinkedList<string> words;
+    words.insertAtEnd("linked");
+    words.insertAtEnd("list");
+    words.emplace_front("singly");
+    words.emplace_at(3, 3, '!');
+    words.display();
+    
+    output << "\n||====> Values built in place with emplace <====||" << '\n';
+    LinkedList<Reading> readings;
+    readings.emplace_back("temp", 21.5);
+    readings.emplace_back("humidity", 40.0);
+    readings.emplace_at(1, "pressure", 1013.0);
+    readings.display();
+    
+    output << "\n||====> std algorithms over forward iterators <====||" << '\n';
+    QuietList<int> numbers;
+    numbers.appendRange(vector<int>{5, 3, 8, 1, 9, 2});
+    int total = 0;
+    for (int value : numbers) {
+        total += value;
+    }
+    auto largest = max_element(numbers.begin(), numbers.end());
+    long evens = count_if(numbers.cbegin(), numbers.cend(), [](int v) { return v % 2 == 0; });
+    output << "Sum: " << total << ", max: " << *largest << ", evens: " << evens << '\n';
+    for (int& value : numbers) {
+        value *= 10;
+    }
+    numbers.display();
+    
+    output << "\n||====> Move-only elements (unique_ptr) <====||" << '\n';
+    QuietList<unique_ptr<int>> owners;
+    owners.emplace_back(new int(7));
+    owners.insertAtBeginning(make_unique<int>(3));
+    owners.emplace_at(1, new int(5));
+    output << "Values:";
+    for (const auto& owner : owners) {
+        output << " " << *owner;
+    }
+    output << '\n';
+    
+    output << "\n||====> Copy and move <====||" << '\n';
+    QuietList<int> copy = numbers;
+    copy.insertAtEnd(100);
+    QuietList<int> moved = std::move(copy);
+    output << "Original: " << numbers.getSize() << " nodes, copy after move: "
+           << copy.getSize() << " nodes, moved-to: " << moved.getSize() << " nodes" << '\n';
+    moved.display();
+    
+    QuietList<unique_ptr<int>> taken;
+    taken = std::move(owners);
+    output << "Moved unique_ptr list: " << taken.getSize() << " nodes, source: "
+           << owners.getSize() << " nodes" << '\n';
+}
+
+// Test Case 11: Lock-free concurrent list under many threads
+void testCase11() {
+    printSection("TEST CASE 11: Concurrent Lock-Free List");
+    
+    const int threads = 4;
+    const int perThread = 5000;
+    
+    output << "\n||====> " << threads << " threads insert, insertAfter and delete their own values <====||" << '\n';
+    ConcurrentLinkedList<int> list;
+    runOnThreads(threads, [&list, perThread](int t) {
+        int base = (t + 1) * 1000000;
+        for (int i = 0; i < perThread; i++) {
+            list.insertAtBeginning(base + i);
+        }
+        // Put a copy of every tenth value right after it
+        for (int i = 0; i < perThread; i += 10) {
+            if (!list.insertAfter(base + i, -(base + i))) {
+                throw runtime_error("insertAfter lost a value");
+            }
+        }
+        // Delete the odd values and check the even ones survive
+        for (int i = 1; i < perThread; i += 2) {
+            if (!list.deleteByValue(base + i)) {
+                throw runtime_error("deleteByValue lost a value");
+            }
+        }
+        for (int i = 0; i < perThread; i += 2) {
+            if (!list.contains(base + i) || list.contains(base + i + 1)) {
+                throw runtime_error("contains saw the wrong values");
+            }
+        }
+    });
+    
+    long expected = threads * (perThread / 2 + perThread / 10);
+    vector<int> values = list.snapshot();
+    output << "Size: " << list.getSize() << ", snapshot: " << values.size()
+           << " (expected " << expected << ")" << '\n';
+    if (list.getSize() != expected || static_cast<long>(values.size()) != expected) {
+        throw runtime_error("Concurrent list lost or duplicated nodes!");
     }
+    
+    output << "\n||====> " << threads << " threads race to delete the same 10000 values <====||" << '\n';
+    ConcurrentLinkedList<int> shared;
+    for (int i = 0; i < 10000; i++) {
+        shared.insertAtBeginning(i);
+    }
+    atomic<int> deleted(0);
+    runOnThreads(threads, [&shared, &deleted](int t) {
+        for (int i = 0; i < 10000; i++) {
+            int value = (t % 2 == 0) ? i : 9999 - i;
+            if (shared.deleteByValue(value)) {
+                deleted.fetch_add(1);
+            }
+        }
+    });
+    output << "Successful deletes: " << deleted.load() << " (expected 10000), remaining: "
+           << shared.getSize() << '\n';
+    if (deleted.load() != 10000 || !shared.snapshot().empty()) {
+        throw runtime_error("Concurrent deletes were not exactly-once!");
+    }
+}
+
+// Test Case 12: Single-pass batch mutations
+void testCase12() {
+    printSection("TEST CASE 12: Batch Mutations");
+    
+    QuietList<int> list;
+    list.appendRange(vector<int>{1, 2, 3, 2, 4, 2, 5, 6, 7, 8});
     list.display();
     
-    cout << "\n||====> Insert 1 at beginning <====||" << endl;
-    list.insertAtBeginning(1);
+    output << "\n||====> deleteAllByValue(2) <====||" << '\n';
+    output << "Deleted: " << list.deleteAllByValue(2) << '\n';
     list.display();
     
-    cout << "\n||====> Insert 7 at position 4 <====||" << endl;
-    list.insertAtMiddle(7, 4);
+    output << "\n||====> removeIf(even) <====||" << '\n';
+    output << "Deleted: " << list.removeIf([](int v) { return v % 2 == 0; }) << '\n';
     list.display();
     
-    cout << "\n||====> Insert 14 at end <====||" << endl;
-    list.insertAtEnd(14);
+    output << "\n||====> deleteValues({1, 7, 99}) <====||" << '\n';
+    set<int> unwanted = {1, 7, 99};
+    output << "Deleted: " << list.deleteValues(unwanted) << '\n';
     list.display();
     
-    cout << "\n||====> Delete values 1, 7, and 14 <====||" << endl;
-    list.deleteByValue(1);
-    list.deleteByValue(7);
-    list.deleteByValue(14);
+    output << "\n||====> insertAtPositions: 10@0, 20@1, 30@2, 40@2 <====||" << '\n';
+    output << "Inserted: " << list.insertAtPositions({{0, 10}, {2, 30}, {1, 20}, {2, 40}}) << '\n';
     list.display();
     
-    cout << "\n||====> Delete positions 0 and 2 <====||" << endl;
-    list.deleteByPosition(0);
-    list.deleteByPosition(2);
+    output << "\n||====> deletePositions({0, 2, 4, 50}) <====||" << '\n';
+    output << "Deleted: " << list.deletePositions({0, 2, 4, 50}) << '\n';
+    list.display();
+    
+    output << "\n||====> Misses return 0 instead of throwing <====||" << '\n';
+    output << "deleteAllByValue(999): " << list.deleteAllByValue(999)
+           << ", deletePositions({100}): " << list.deletePositions({100}) << '\n';
+    
+    output << "\n||====> removeIf with a predicate that throws part way <====||" << '\n';
+    QuietList<int> indexed;
+    vector<int> mirror;
+    for (int i = 0; i < 2000; i++) {
+        mirror.push_back(i % 100);
+    }
+    indexed.appendRange(mirror);
+    indexed.enableValueIndex();
+    indexed.at(1000);  // Build the positional index as well
+    try {
+        indexed.removeIf([](int v) {
+            if (v == 99) {
+                throw runtime_error("predicate failed");
+            }
+            return v % 3 == 0;
+        });
+    } catch (const exception& e) {
+        output << "X Error caught: " << e.what() << '\n';
+    }
+    // Everything before the first 99 was filtered, the rest is untouched
+    auto firstFailure = find(mirror.begin(), mirror.end(), 99);
+    mirror.erase(remove_if(mirror.begin(), firstFailure, [](int v) { return v % 3 == 0; }), firstFailure);
+    bool inSync = indexed.getSize() == static_cast<int>(mirror.size());
+    for (int i = 0; inSync && i < indexed.getSize(); i++) {
+        inSync = indexed.at(i) == mirror[i];
+    }
+    for (int value = 0; inSync && value < 100; value++) {
+        inSync = indexed.count(value) == static_cast<int>(std::count(mirror.begin(), mirror.end(), value));
+    }
+    output << "Positions and counts match: " << (inSync ? "yes" : "no") << '\n';
+}
+
+// Test Case 13: Sorting, merging and sorted insertion
+void testCase13() {
+    printSection("TEST CASE 13: Sorting and Merging");
+    
+    output << "\n||====> In-place merge sort <====||" << '\n';
+    QuietList<int> list;
+    list.appendRange(vector<int>{42, 7, 19, 3, 25, 7, 88, 1});
+    list.display();
+    list.sort();
+    list.display();
+    
+    output << "\n||====> Stable sort with a custom comparator <====||" << '\n';
+    QuietList<Reading> readings;
+    readings.emplace_back("temp", 21.5);
+    readings.emplace_back("humidity", 40.0);
+    readings.emplace_back("temp", 19.0);
+    readings.emplace_back("pressure", 1013.0);
+    readings.emplace_back("humidity", 38.5);
+    readings.sort([](const Reading& a, const Reading& b) { return a.sensor < b.sensor; });
+    readings.display();
+    
+    output << "\n||====> Merge two sorted lists <====||" << '\n';
+    QuietList<int> other;
+    other.appendRange(vector<int>{2, 7, 50, 100});
+    list.merge(other);
+    list.display();
+    output << "Other list after merge: " << other.getSize() << " nodes" << '\n';
+    
+    output << "\n||====> Sorted insertion <====||" << '\n';
+    LinkedList<int> ordered;
+    ordered.appendRange(vector<int>{10, 20, 30});
+    ordered.sortedInsert(25);
+    ordered.sortedInsert(5);
+    ordered.sortedInsert(40);
+    ordered.display();
+    
+    output << "\n||====> Large list: sort vs parallel sort <====||" << '\n';
+    const int count = 200000;
+    mt19937 rng(2024);
+    vector<int> values(count);
+    for (int& value : values) {
+        value = static_cast<int>(rng() % 1000000);
+    }
+    
+    QuietList<int> serial;
+    serial.appendRange(values);
+    auto start = chrono::steady_clock::now();
+    serial.sort();
+    double serialMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    
+    QuietList<int> parallel;
+    parallel.appendRange(values);
+    start = chrono::steady_clock::now();
+    parallel.parallelSort(4);
+    double parallelMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    
+    bool same = equal(serial.begin(), serial.end(), parallel.begin());
+    output << count << " nodes - sort: " << serialMs << " ms, parallelSort(4): " << parallelMs
+           << " ms, sorted: " << (serial.isSorted() ? "yes" : "no")
+           << ", results match: " << (same ? "yes" : "no") << '\n';
+    
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < 20000; i++) {
+        serial.sortedInsert(static_cast<int>(rng() % 1000000));
+    }
+    double insertMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    output << "20000 sortedInsert calls: " << insertMs << " ms, still sorted: "
+           << (serial.isSorted() ? "yes" : "no") << '\n';
+}
+
+// Test Case 14: Binary snapshots
+void testCase14() {
+    printSection("TEST CASE 14: Binary Snapshots");
+    const string path = "list_snapshot.bin";
+    
+    output << "\n||====> Save and load a small list <====||" << '\n';
+    QuietList<int> list;
+    list.appendRange(vector<int>{10, 20, 30, 40, 50});
+    list.saveSnapshot(path);
+    QuietList<int> restored;
+    restored.loadSnapshot(path);
+    restored.display();
+    
+    output << "\n||====> Corrupt snapshots are rejected <====||" << '\n';
+    FILE* file = fopen(path.c_str(), "r+b");
+    fseek(file, static_cast<long>(sizeof(SnapshotHeader)), SEEK_SET);
+    fputc(0x7F, file);
+    fclose(file);
+    try {
+        restored.loadSnapshot(path);
+    } catch (const runtime_error& e) {
+        output << "Error: " << e.what() << '\n';
+    }
+    output << "List left unchanged: ";
+    restored.display();
+    try {
+        LinkedList<double> wrongType;
+        list.saveSnapshot(path);
+        wrongType.loadSnapshot(path);
+    } catch (const runtime_error& e) {
+        output << "Error: " << e.what() << '\n';
+    }
+    
+    output << "\n||====> Warm restart of a large list <====||" << '\n';
+    const int count = 1000000;
+    QuietList<int> large;
+    for (int i = 0; i < count; i++) {
+        large.insertAtEnd(i * 7);
+    }
+    auto start = chrono::steady_clock::now();
+    large.saveSnapshot(path);
+    double saveMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    
+    QuietList<int> reloaded;
+    start = chrono::steady_clock::now();
+    reloaded.loadSnapshot(path);
+    double loadMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    bool same = equal(large.begin(), large.end(), reloaded.begin());
+    output << count << " values - save: " << saveMs << " ms, load: " << loadMs
+           << " ms, slabs: " << reloaded.allocatorStats().slabCount
+           << ", contents match: " << (same ? "yes" : "no") << '\n';
+    
+    output << "\n||====> Streaming writer and reader <====||" << '\n';
+    // Neither side holds more than one chunk, so this works for any length
+    {
+        SnapshotWriter<long long> writer(path);
+        for (long long i = 1; i <= 2000000; i++) {
+            writer.write(i);
+        }
+        writer.close();
+    }
+    SnapshotReader<long long> reader(path);
+    long long sum = 0;
+    int chunks = 0;
+    reader.forEachChunk([&](const long long* values, size_t n) {
+        for (size_t i = 0; i < n; i++) {
+            sum += values[i];
+        }
+        chunks++;
+    });
+    output << "Streamed " << reader.count() << " values in " << chunks << " chunks, sum: " << sum << '\n';
+    
+    remove(path.c_str());
+}
+
+// Test Case 15: Hot-path metrics (needs -DLIST_METRICS=1)
+void testCase15() {
+    printSection("TEST CASE 15: List Metrics");
+    
+#if LIST_METRICS
+    QuietList<int> list;
+    mt19937 rng(15);
+    int hits = 0;
+    
+    output << "\n||====> Mixed workload on a growing list <====||" << '\n';
+    for (int i = 0; i < 5000; i++) {
+        list.insertAtEnd(static_cast<int>(rng() % 1000));
+    }
+    for (int i = 0; i < 2000; i++) {
+        list.insertAtMiddle(i, static_cast<int>(rng() % (list.getSize() + 1)));
+        list.deleteByPosition(static_cast<int>(rng() % list.getSize()));
+        hits += list.contains(static_cast<int>(rng() % 2000)) ? 1 : 0;
+        try {
+            list.deleteByValue(static_cast<int>(rng() % 2000));
+        } catch (const runtime_error&) {
+            // Misses are counted as failures
+        }
+    }
+    list.removeIf([](int v) { return v % 7 == 0; });
+    list.sort();
+    output << "contains() hits: " << hits << '\n';
+    list.metricsSnapshot().print(output);
+    
+    output << "\n||====> After resetMetrics() <====||" << '\n';
+    list.resetMetrics();
+    list.at(list.getSize() / 2);
+    list.clear();
+    list.metricsSnapshot().print(output);
+#else
+    output << "Metrics are compiled out; rebuild with -DLIST_METRICS=1 to see them." << '\n';
+#endif
+}
+
+// Test Case 16: Compaction of a fragmented chain
+void testCase16() {
+    printSection("TEST CASE 16: Memory Compaction");
+    
+    output << "\n||====> Small list keeps its order <====||" << '\n';
+    QuietList<int> small;
+    for (int i = 0; i < 6; i++) {
+        small.insertAtMiddle(i * 10, i / 2);
+    }
+    small.display();
+    small.compact();
+    small.display();
+    
+    // Nodes inserted at random positions end up in list order that has
+    // nothing to do with their order in memory
+    const int count = 200000;
+    QuietList<int> list;
+    mt19937 rng(16);
+    for (int i = 0; i < count; i++) {
+        list.insertAtMiddle(i, static_cast<int>(rng() % (list.getSize() + 1)));
+    }
+    
+    auto timeTraversal = [&list]() {
+        auto start = chrono::steady_clock::now();
+        long long sum = 0;
+        for (int round = 0; round < 5; round++) {
+            for (int value : list) {
+                sum += value;
+            }
+        }
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count() / 5;
+        return make_pair(ms, sum / 5);
+    };
+    
+    output << "\n||====> One-shot compact() <====||" << '\n';
+    auto before = timeTraversal();
+    auto start = chrono::steady_clock::now();
+    list.compact();
+    double compactMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    auto after = timeTraversal();
+    output << count << " nodes - traversal before: " << before.first << " ms, compact: " << compactMs
+           << " ms, traversal after: " << after.first << " ms, same sum: "
+           << (before.second == after.second ? "yes" : "no") << '\n';
+    
+    output << "\n||====> Incremental compactStep() between other work <====||" << '\n';
+    for (int i = 0; i < 20000; i++) {
+        list.deleteByPosition(static_cast<int>(rng() % list.getSize()));
+        list.insertAtMiddle(count + i, static_cast<int>(rng() % (list.getSize() + 1)));
+    }
+    before = timeTraversal();
+    int steps = 0;
+    bool done = false;
+    while (!done) {
+        done = list.compactStep(4096);
+        steps++;
+        // Keep using the list while the pass is under way
+        list.insertAtMiddle(-steps, static_cast<int>(rng() % (list.getSize() + 1)));
+        list.deleteByPosition(static_cast<int>(rng() % list.getSize()));
+    }
+    after = timeTraversal();
+    long long expected = 0;
+    for (int value : list) {
+        expected += value;
+    }
+    output << "Pass finished in " << steps << " steps of 4096 nodes - traversal before: "
+           << before.first << " ms, after: " << after.first << " ms, size: " << list.getSize()
+           << ", contents intact: " << (after.second == expected && before.second != 0 ? "yes" : "no") << '\n';
+}
+
+// Test Case 17: Workload traces
+void testCase17() {
+    printSection("TEST CASE 17: Workload Trace Replay");
+    const string path = "list_trace.bin";
+    
+    output << "\n||====> Records round-trip through the encoding <====||" << '\n';
+    {
+        TraceWriter writer(path);
+        writer.write({TraceOp::InsertAtEnd, 10, 0});
+        writer.write({TraceOp::InsertAtEnd, -30, 0});
+        writer.write({TraceOp::InsertAtMiddle, 20, 1});
+        writer.write({TraceOp::InsertAtBeginning, 5, 0});
+        writer.write({TraceOp::DeleteByValue, -30, 0});
+        writer.write({TraceOp::DeleteByPosition, 0, 7});  // Out of range
+        writer.write({TraceOp::Display, 0, 0});
+        writer.close();
+    }
+    TraceReader reader(path);
+    reader.forEachRecord([&](const TraceRecord& record) {
+        output << traceOpName(record.op);
+        if (traceOpHasValue(record.op)) {
+            output << " value=" << record.value;
+        }
+        if (traceOpHasPosition(record.op)) {
+            output << " position=" << record.position;
+        }
+        output << '\n';
+    });
+    ReplayReport small = replayTraceFile(path, true, false);
+    output << reader.count() << " records in " << reader.payloadBytes() << " bytes, final size: "
+           << small.finalSize << ", errors: " << small.ops[static_cast<int>(TraceOp::DeleteByPosition)].errors << '\n';
+    
+    output << "\n||====> Unfinished traces are rejected <====||" << '\n';
+    {
+        TraceWriter abandoned(path);
+        abandoned.write({TraceOp::Clear, 0, 0});
+        // Destroyed without close(), so the header never gets its magic
+    }
+    try {
+        replayTraceFile(path, false, false);
+    } catch (const runtime_error& e) {
+        output << "Error: " << e.what() << '\n';
+    }
+    
+    output << "\n||====> Synthetic trace replayed from a mapping and a buffer <====||" << '\n';
+    TraceMix mix;
+    mix.targetSize = 2000;
+    mix.pattern = AccessPattern::Skewed;
+    generateTrace(path, 500000, mix, 17);
+    ReplayReport mapped = replayTraceFile(path, false, false);
+    printReplayReport(mapped);
+    ReplayReport buffered = replayTraceFile(path, true, false);
+    output << "Buffered replay:\n";
+    printReplayReport(buffered);
+    uint64_t errors = 0;
+    for (const TraceOpStats& stats : mapped.ops) {
+        errors += stats.errors;
+    }
+    output << "Final sizes agree: " << (mapped.finalSize == buffered.finalSize ? "yes" : "no")
+           << ", errors: " << errors << '\n';
+    
+    remove(path.c_str());
+}
+
+// Test Case 18: Status-returning try* operations
+void testCase18() {
+    printSection("TEST CASE 18: Non-Throwing Fast Path");
+    
+    output << "\n||====> try* calls report misses as a status <====||" << '\n';
+    QuietList<int> list;
+    output << "tryDeleteByValue(1) on empty list: " << listStatusName(list.tryDeleteByValue(1)) << '\n';
+    list.appendRange(vector<int>{10, 20, 30});
+    output << "tryInsertAtMiddle(15, 1): " << listStatusName(list.tryInsertAtMiddle(15, 1)) << '\n';
+    output << "tryInsertAtMiddle(99, 9): " << listStatusName(list.tryInsertAtMiddle(99, 9)) << '\n';
+    output << "tryDeleteByPosition(-1): " << listStatusName(list.tryDeleteByPosition(-1)) << '\n';
+    output << "tryDeleteByValue(42): " << listStatusName(list.tryDeleteByValue(42)) << '\n';
+    output << "tryDeleteByValue(20): " << listStatusName(list.tryDeleteByValue(20)) << '\n';
+    list.display();
+    
+    output << "\n||====> Miss-path cost: throwing vs try* <====||" << '\n';
+    // The value index makes a miss O(1), so what is measured is the cost
+    // of reporting it
+    QuietList<int> large;
+    for (int i = 0; i < 1000; i++) {
+        large.insertAtEnd(i);
+    }
+    large.enableValueIndex();
+    const int misses = 200000;
+    
+    // Miss keys come from memory so the compiler cannot prove the calls fail
+    mt19937 rng(18);
+    vector<int> keys(misses);
+    for (int& key : keys) {
+        key = 1000 + static_cast<int>(rng() % 1000);
+    }
+    
+    auto measure = [&](const char* name, auto throwing, auto nonThrowing) {
+        long long allocsBefore = heapAllocations;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < misses; i++) {
+            try {
+                throwing(i);
+            } catch (const exception&) {
+            }
+        }
+        double throwNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / misses;
+        double throwAllocs = static_cast<double>(heapAllocations - allocsBefore) / misses;
+        
+        allocsBefore = heapAllocations;
+        int failures = 0;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < misses; i++) {
+            failures += nonThrowing(i) != ListStatus::Ok;
+        }
+        double tryNs = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count() / misses;
+        double tryAllocs = static_cast<double>(heapAllocations - allocsBefore) / misses;
+        
+        output << left << setw(18) << name << right << fixed << setprecision(1)
+               << setw(10) << throwNs << " ns (" << throwAllocs << " allocs)"
+               << setw(10) << tryNs << " ns (" << tryAllocs << " allocs)"
+               << setw(8) << setprecision(0) << throwNs / max(tryNs, 0.1) << "x  misses: " << failures << '\n';
+        output << defaultfloat << setprecision(6);
+    };
+    
+    output << left << setw(18) << "operation" << right << setw(28) << "throwing" << setw(28) << "try*"
+           << setw(9) << "speedup" << '\n';
+    measure("deleteByValue",
+            [&](int i) { large.deleteByValue(keys[i]); },
+            [&](int i) { return large.tryDeleteByValue(keys[i]); });
+    measure("deleteByPosition",
+            [&](int i) { large.deleteByPosition(keys[i]); },
+            [&](int i) { return large.tryDeleteByPosition(keys[i]); });
+    measure("insertAtMiddle",
+            [&](int i) { large.insertAtMiddle(i, keys[i] + 1); },
+            [&](int i) { return large.tryInsertAtMiddle(i, keys[i] + 1); });
+    output << "Size unchanged: " << (large.getSize() == 1000 ? "yes" : "no") << '\n';
+}
+
+// Test Case 19: Relinking nodes between lists
+void testCase19() {
+    printSection("TEST CASE 19: Splice, Split and Concatenate");
+    
+    auto fill = [](QuietList<int>& list, int from, int to) {
+        for (int i = from; i < to; i++) {
+            list.insertAtEnd(i);
+        }
+    };
+    
+    output << "\n||====> splice() and concat() <====||" << '\n';
+    QuietList<int> list;
+    QuietList<int> other;
+    fill(list, 0, 4);
+    fill(other, 10, 13);
+    long long allocsBefore = heapAllocations;
+    list.splice(2, other);
+    list.display();
+    output << "Source size: " << other.getSize() << ", allocations: " << heapAllocations - allocsBefore << '\n';
+    fill(other, 20, 22);
+    list.concat(other);
+    other.insertAtEnd(99);  // The emptied source is still usable
+    list.display();
+    other.display();
+    
+    output << "\n||====> spliceRange() between and within lists <====||" << '\n';
+    other.clear();
+    fill(other, 100, 106);
+    list.spliceRange(0, other, 2, 3);
+    list.display();
+    other.display();
+    list.spliceRange(list.getSize(), list, 0, 3);  // Rotate the block to the end
+    list.display();
+    try {
+        list.spliceRange(2, list, 0, 4);
+    } catch (const exception& e) {
+        output << "Error: " << e.what() << '\n';
+    }
+    
+    output << "\n||====> splitAt() and swap() <====||" << '\n';
+    QuietList<int> rest = list.splitAt(5);
     list.display();
+    rest.display();
+    list.swap(rest);
+    output << "After swap - sizes: " << list.getSize() << " and " << rest.getSize() << '\n';
+    
+    output << "\n||====> Large transfers relink instead of copying <====||" << '\n';
+    const int count = 1000000;
+    QuietList<int> big;
+    fill(big, 0, count);
+    allocsBefore = heapAllocations;
+    auto start = chrono::steady_clock::now();
+    QuietList<int> back = big.splitAt(count / 2);
+    QuietList<int> front;
+    front.splice(0, big);
+    front.concat(back);
+    double us = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    long long sum = 0;
+    for (int value : front) {
+        sum += value;
+    }
+    output << count << " nodes split, spliced and joined in " << us << " us, allocations: "
+           << heapAllocations - allocsBefore << ", live nodes: " << front.allocatorStats().liveNodes
+           << ", contents intact: " << (sum == 1LL * count * (count - 1) / 2 ? "yes" : "no") << '\n';
+    
+    output << "\n||====> concat() extends the indexes of the list it grows <====||" << '\n';
+    QuietList<int> indexed;
+    QuietList<int> tailPart;
+    vector<int> expected;
+    for (int i = 0; i < 3000; i++) {
+        indexed.insertAtEnd(i % 100);
+        tailPart.insertAtEnd(i % 70);
+    }
+    indexed.enableValueIndex();
+    indexed.at(10);
+    for (int i = 0; i < 50; i++) {  // Leave freed slots on both sides
+        indexed.deleteByValue(i);
+        tailPart.deleteByPosition(0);
+    }
+    for (int value : indexed) {
+        expected.push_back(value);
+    }
+    for (int value : tailPart) {
+        expected.push_back(value);
+    }
+    indexed.concat(tailPart);
+    bool kept = indexed.hasPositionIndex();
+    for (int i = 0; i < 100; i++) {  // Reuse the joined free slots
+        indexed.insertAtMiddle(i, i * 7);
+        expected.insert(expected.begin() + i * 7, i);
+        indexed.deleteByValue(i % 70);
+        expected.erase(find(expected.begin(), expected.end(), i % 70));
+    }
+    bool matches = indexed.getSize() == static_cast<int>(expected.size());
+    for (int i = 0; matches && i < indexed.getSize(); i++) {
+        matches = indexed.at(i) == expected[i];
+    }
+    for (int value = 0; matches && value < 100; value++) {
+        matches = indexed.count(value) == static_cast<int>(std::count(expected.begin(), expected.end(), value));
+    }
+    output << "Positional index kept: " << (kept ? "yes" : "no")
+           << ", positions and counts match: " << (matches ? "yes" : "no") << '\n';
+
+    // Split-off nodes keep their slabs alive after the source is gone
+    QuietList<int> survivor;
+    {
+        QuietList<int> source;
+        fill(source, 0, 1000);
+        source.enableValueIndex();
+        survivor = source.splitAt(990);
+    }
+    survivor.insertAtEnd(1000);
+    survivor.display();
+    output << "contains(995): " << (survivor.contains(995) ? "yes" : "no")
+           << ", contains(5): " << (survivor.contains(5) ? "yes" : "no") << '\n';
+}
+
+// Test Case 20: Persistent list versions
+void testCase20() {
+    printSection("TEST CASE 20: Persistent List");
+    
+    output << "\n||====> Every update returns a new version <====||" << '\n';
+    vector<int> values = {10, 20, 30, 40};
+    PersistentList<int> v1(values.begin(), values.end());
+    PersistentList<int> v2 = v1.pushFront(5);
+    PersistentList<int> v3 = v2.insertAt(3, 25);
+    PersistentList<int> v4 = v3.deleteByValue(10).popFront();
+    v1.display();
+    v2.display();
+    v3.display();
+    v4.display();
+    output << "v2 shares v1 after its head: " << (v2.popFront().sharesWith(v1) ? "yes" : "no") << '\n';
+    try {
+        v4.deleteAt(9);
+    } catch (const exception& e) {
+        output << "Error: " << e.what() << '\n';
+    }
+    
+    output << "\n||====> Snapshots are O(1) <====||" << '\n';
+    const int count = 1000000;
+    PersistentList<int> big;
+    QuietList<int> mutableList;
+    for (int i = count - 1; i >= 0; i--) {
+        big = big.pushFront(i);
+        mutableList.insertAtBeginning(i);
+    }
+    const int snapshots = 100;
+    auto start = chrono::steady_clock::now();
+    vector<PersistentList<int>> versions(snapshots);
+    for (PersistentList<int>& version : versions) {
+        version = big.snapshot();
+    }
+    double persistentUs = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / snapshots;
+    start = chrono::steady_clock::now();
+    QuietList<int> copy(mutableList);
+    double copyUs = chrono::duration<double, micro>(chrono::steady_clock::now() - start).count();
+    output << count << " values - persistent snapshot: " << persistentUs << " us, LinkedList copy: "
+           << copyUs << " us" << '\n';
+    versions.clear();
+    
+    output << "\n||====> Readers keep their version while a writer moves on <====||" << '\n';
+    // Each reader gets its own copy of the version; the writer keeps
+    // replacing its own, so nodes are released while readers still walk
+    // the ones they share
+    const long long expected = 1LL * count * (count - 1) / 2;
+    PersistentList<int> published = big;
+    atomic<int> intact(0);
+    vector<thread> readers;
+    for (int r = 0; r < 4; r++) {
+        readers.emplace_back([&intact, expected, version = published.snapshot()]() {
+            for (int round = 0; round < 3; round++) {
+                long long sum = 0;
+                for (int value : version) {
+                    sum += value;
+                }
+                intact += (sum == expected && version.getSize() == count);
+            }
+        });
+    }
+    for (int i = 0; i < 20000; i++) {
+        published = published.popFront().pushFront(-i).insertAt(i % 16, i);
+    }
+    big = PersistentList<int>();
+    for (thread& reader : readers) {
+        reader.join();
+    }
+    output << "Reads that saw the snapshot intact: " << intact.load() << " of 12, writer size: "
+           << published.getSize() << '\n';
 }
 
 // Main function
-int main() {
-    cout << "\n";
-    cout << "||=============================================||" << endl;
-    cout << "||   SINGLY LINKED LIST IMPLEMENTATION IN C++  ||" << endl;
-    cout << "||=============================================||" << endl;
+// Pass --bench-concurrent [threads] to run the concurrent scaling benchmark
+int main(int argc, char* argv[]) {
+    // stoi and friends report bad numbers as invalid_argument or
+    // out_of_range naming only themselves, so say which value it was
+    auto parse = [](const string& option, const string& value, auto convert) {
+        try {
+            return convert(value);
+        } catch (const logic_error&) {
+            throw runtime_error("Invalid value " + value + " for " + option + "!");
+        }
+    };
+    
+    // --bench-concurrent [maxThreads]
+    if (argc > 1 && string(argv[1]) == "--bench-concurrent") {
+        try {
+            int maxThreads = static_cast<int>(max(1u, thread::hardware_concurrency()));
+            if (argc > 2) {
+                maxThreads = parse("the thread count", argv[2], [](const string& v) { return stoi(v); });
+            }
+            if (maxThreads < 1) {
+                throw runtime_error("The thread count must be at least 1!");
+            }
+            benchmarkConcurrentList(maxThreads, 50000);
+        } catch (const exception& e) {
+            output << "Error: " << e.what() << '\n';
+            output.flush();
+            return 1;
+        }
+        output.flush();
+        return 0;
+    }
+    
+    // --bench [maxSize] [--csv file] [--json file]
+    if (argc > 1 && string(argv[1]) == "--bench") {
+        try {
+            int maxSize = 10000000;
+            string csvPath;
+            string jsonPath;
+            for (int i = 2; i < argc; i++) {
+                string arg = argv[i];
+                if (arg == "--csv" || arg == "--json") {
+                    if (i + 1 >= argc) {
+                        throw runtime_error("Missing file name after " + arg + "!");
+                    }
+                    if (arg == "--csv") {
+                        csvPath = argv[++i];
+                    } else {
+                        jsonPath = argv[++i];
+                    }
+                } else if (arg.rfind("--", 0) == 0) {
+                    throw runtime_error("Unknown option " + arg + "!");
+                } else {
+                    maxSize = parse("the benchmark size", arg, [](const string& v) { return stoi(v); });
+                }
+            }
+            if (maxSize < 1) {
+                throw runtime_error("The benchmark size must be at least 1!");
+            }
+            runBenchmarkSuite(maxSize, csvPath, jsonPath);
+        } catch (const exception& e) {
+            output << "Error: " << e.what() << '\n';
+            output.flush();
+            return 1;
+        }
+        output.flush();
+        return 0;
+    }
+    
+    // --trace-gen file records [--size N] [--pattern head|tail|uniform|skewed]
+    //             [--mix w0,...,w6] [--seed S]
+    if (argc > 3 && string(argv[1]) == "--trace-gen") {
+        try {
+            TraceMix mix;
+            unsigned seed = 1;
+            
+            uint64_t records = parse("the record count", argv[3], [](const string& v) { return stoull(v); });
+            for (int i = 4; i + 1 < argc; i += 2) {
+                string arg = argv[i];
+                string value = argv[i + 1];
+                if (arg == "--size") {
+                    mix.targetSize = parse(arg, value, [](const string& v) { return stoi(v); });
+                } else if (arg == "--pattern") {
+                    mix.pattern = parseAccessPattern(value);
+                } else if (arg == "--seed") {
+                    seed = parse(arg, value, [](const string& v) { return static_cast<unsigned>(stoul(v)); });
+                } else if (arg == "--mix") {
+                    stringstream weights(value);
+                    string weight;
+                    for (int op = 0; op < traceOpCount && getline(weights, weight, ','); op++) {
+                        mix.weights[op] = parse(arg, weight, [](const string& v) { return stod(v); });
+                    }
+                }
+            }
+            generateTrace(argv[2], records, mix, seed);
+        } catch (const exception& e) {
+            output << "Error: " << e.what() << '\n';
+            output.flush();
+            return 1;
+        }
+        output << "Wrote " << argv[3] << " records to " << argv[2] << '\n';
+        output.flush();
+        return 0;
+    }
+    
+    // --trace-replay file [--buffered] [--value-index]
+    if (argc > 2 && string(argv[1]) == "--trace-replay") {
+        try {
+            bool buffered = false;
+            bool valueIndex = false;
+            for (int i = 3; i < argc; i++) {
+                buffered = buffered || string(argv[i]) == "--buffered";
+                valueIndex = valueIndex || string(argv[i]) == "--value-index";
+            }
+            printReplayReport(replayTraceFile(argv[2], buffered, valueIndex));
+        } catch (const exception& e) {
+            output << "Error: " << e.what() << '\n';
+            output.flush();
+            return 1;
+        }
+        output.flush();
+        return 0;
+    }
+    
+    output << "\n";
+    output << "||=============================================||" << '\n';
+    output << "||   SINGLY LINKED LIST IMPLEMENTATION IN C++  ||" << '\n';
+    output << "||=============================================||" << '\n';
     
     try {
         testCase1();
         testCase2();
         testCase3();
+        testCase4();
+        testCase5();
+        testCase6();
+        testCase7();
+        testCase8();
+        testCase9();
+        testCase10();
+        testCase11();
+        testCase12();
+        testCase13();
+        testCase14();
+        testCase15();
+        testCase16();
+        testCase17();
+        testCase18();
+        testCase19();
+        testCase20();
         
         printSection("ALL TESTS COMPLETED SUCCESSFULLY");
         
     } catch (const exception& e) {
-        cout << "\nX Unexpected error: " << e.what() << endl;
+        output << "\nX Unexpected error: " << e.what() << '\n';
+        output.flush();
         return 1;
     }
     
+    output.flush();
     return 0;
 }